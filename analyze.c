@@ -0,0 +1,427 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include "connect_four.h"
+#include "engine.h"
+#include "rl_agent.h"
+#include "book.h"
+#include "timeutil.h"
+
+// =======================================================
+// Batch position analysis (c4_analyze)
+// =======================================================
+//
+// Streams positions, one move string per line (columns 1-7 from the empty
+// board, e.g. "4453"; an empty line is the empty board), and writes one
+// line per input line, in input order:
+//   C SCORE       best column for the side to move and the engine's score
+//                 from its side (minimax evaluation, solver score or RL
+//                 value)
+//   - over        the line ends the game
+//   - illegal     bad character, full column, move after the end, or too
+//                 long
+//
+// The main thread reads into a fixed ring of slots, a pool of workers
+// (each with its own engine context) analyzes them in any order and a
+// writer thread prints them in order, so memory does not grow with the
+// input. Every position starts from a cleared hash table and a generator
+// seeded from its line number: the output does not depend on the number
+// of threads.
+//
+// Engine specs:
+//   minimax:D            minimax CPU at depth D
+//   solver               exact solver
+//   rl:PATH[:K]          self-learning model file PATH, search depth K (3)
+
+#define ANALYZE_LINE_MAX   128
+#define ANALYZE_SLOTS      256   // per worker
+#define ANALYZE_MAX_THREADS 64
+#define RL_ANALYZE_DEPTH   3
+#define ANALYZE_HASH_MB    1
+
+enum { ENGINE_MINIMAX, ENGINE_SOLVER, ENGINE_RL };
+enum { SLOT_FREE, SLOT_READY, SLOT_DONE };
+enum { RESULT_MOVE, RESULT_OVER, RESULT_ILLEGAL };
+
+typedef struct {
+    char   line[ANALYZE_LINE_MAX];
+    int    tooLong;
+    int    state;       // SLOT_*
+    int    result;      // RESULT_*
+    int    move;
+    double score;
+} Slot;
+
+typedef struct {
+    int      kind;
+    int      depth;
+    RLAgent *agent;
+    const Book *book;
+    uint64_t seed;
+
+    Slot    *slots;
+    size_t   slotCount;
+
+    // Lines read, handed to workers and written; slot = line % slotCount
+    pthread_mutex_t lock;
+    pthread_cond_t  workReady;   // reader -> workers
+    pthread_cond_t  slotDone;    // workers -> writer
+    pthread_cond_t  slotFree;    // writer -> reader
+    unsigned long long readCount;
+    unsigned long long nextWork;
+    unsigned long long writeCount;
+    int      eof;
+
+    FILE    *out;
+    long long nodes;             // totals, under `lock`
+} Analyzer;
+
+typedef struct {
+    Analyzer *an;
+    pthread_t thread;
+    C4Engine  ctx;
+} Worker;
+
+// ---------------- Engines ----------------
+
+static int parseEngine(const char *spec, Analyzer *an) {
+    if (strcmp(spec, "solver") == 0) {
+        an->kind = ENGINE_SOLVER;
+        an->depth = 0;
+        return 1;
+    }
+    if (strncmp(spec, "minimax:", 8) == 0) {
+        char *end;
+        long depth = strtol(spec + 8, &end, 10);
+        if (end == spec + 8 || *end != '\0' || depth < 1 || depth > ROWS * COLS) return 0;
+        an->kind = ENGINE_MINIMAX;
+        an->depth = (int)depth;
+        return 1;
+    }
+    if (strncmp(spec, "rl:", 3) == 0) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s", spec + 3);
+        an->kind = ENGINE_RL;
+        an->depth = RL_ANALYZE_DEPTH;
+
+        // Optional ":K" suffix (a path may contain ':' itself)
+        char *colon = strrchr(path, ':');
+        if (colon) {
+            char *end;
+            long depth = strtol(colon + 1, &end, 10);
+            if (end != colon + 1 && *end == '\0' && depth >= 1) {
+                an->depth = (int)depth;
+                *colon = '\0';
+            }
+        }
+
+        an->agent = malloc(sizeof(RLAgent));
+        if (!an->agent) return 0;
+        rl_init(an->agent);
+        if (!rl_load(an->agent, path)) {
+            fprintf(stderr, "Could not load model %s\n", path);
+            free(an->agent);
+            an->agent = NULL;
+            return 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// ---------------- Workers ----------------
+
+// Play a move string from the empty board. Returns RESULT_MOVE if the side
+// to move has a move to find.
+static int playLine(const char *line, char board[ROWS][COLS], char *toMove) {
+    initializeBoard(board);
+    *toMove = PLAYER1;
+    int over = 0;
+    for (const char *p = line; *p && *p != '\n' && *p != '\r'; p++) {
+        int c = *p - '1';
+        if (over || c < 0 || c >= COLS || !isMoveValid(board, c)) return RESULT_ILLEGAL;
+        int r = dropPiece(board, c, *toMove);
+        if (checkWin(board, *toMove, r, c) || isBoardFull(board)) over = 1;
+        *toMove = (*toMove == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+    return over ? RESULT_OVER : RESULT_MOVE;
+}
+
+static void analyzeSlot(Worker *w, Slot *s, unsigned long long lineNo) {
+    Analyzer *an = w->an;
+    char board[ROWS][COLS];
+    char toMove;
+
+    s->result = s->tooLong ? RESULT_ILLEGAL : playLine(s->line, board, &toMove);
+    if (s->result != RESULT_MOVE) return;
+
+    clearCPUHash(&w->ctx);
+    seedCPUEngine(&w->ctx, an->seed ^ (lineNo * 0x9E3779B97F4A7C15ULL));
+    if (an->kind == ENGINE_RL) {
+        s->move = rl_choose_move(an->agent, &w->ctx, board, toMove, 0.0);
+    } else {
+        s->move = getCPUMove(&w->ctx, board, toMove);
+    }
+    s->score = w->ctx.stats.score;
+}
+
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    Analyzer *an = w->an;
+    long long nodes = 0;
+
+    pthread_mutex_lock(&an->lock);
+    for (;;) {
+        while (an->nextWork == an->readCount && !an->eof) {
+            pthread_cond_wait(&an->workReady, &an->lock);
+        }
+        if (an->nextWork == an->readCount) break;   // input done
+        unsigned long long lineNo = an->nextWork++;
+        Slot *s = &an->slots[lineNo % an->slotCount];
+        pthread_mutex_unlock(&an->lock);
+
+        analyzeSlot(w, s, lineNo);
+        if (s->result == RESULT_MOVE) nodes += w->ctx.stats.nodes;
+
+        pthread_mutex_lock(&an->lock);
+        s->state = SLOT_DONE;
+        if (lineNo == an->writeCount) pthread_cond_signal(&an->slotDone);
+    }
+    an->nodes += nodes;
+    pthread_mutex_unlock(&an->lock);
+    return NULL;
+}
+
+// Print finished slots in input order and hand them back to the reader.
+static void *writerMain(void *arg) {
+    Analyzer *an = arg;
+
+    pthread_mutex_lock(&an->lock);
+    for (;;) {
+        Slot *s = &an->slots[an->writeCount % an->slotCount];
+        if (an->writeCount == an->readCount) {
+            if (an->eof) break;
+            pthread_cond_wait(&an->slotDone, &an->lock);
+            continue;
+        }
+        if (s->state != SLOT_DONE) {
+            pthread_cond_wait(&an->slotDone, &an->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&an->lock);
+
+        if (s->result == RESULT_MOVE)      fprintf(an->out, "%d %g\n", s->move + 1, s->score);
+        else if (s->result == RESULT_OVER) fputs("- over\n", an->out);
+        else                               fputs("- illegal\n", an->out);
+
+        pthread_mutex_lock(&an->lock);
+        s->state = SLOT_FREE;
+        an->writeCount++;
+        pthread_cond_signal(&an->slotFree);
+    }
+    pthread_mutex_unlock(&an->lock);
+    fflush(an->out);
+    return NULL;
+}
+
+// Fill the ring from `in` until end of input.
+static void readInput(Analyzer *an, FILE *in) {
+    char buf[ANALYZE_LINE_MAX];
+
+    for (;;) {
+        pthread_mutex_lock(&an->lock);
+        while (an->readCount - an->writeCount == an->slotCount) {
+            pthread_cond_wait(&an->slotFree, &an->lock);
+        }
+        Slot *s = &an->slots[an->readCount % an->slotCount];
+        pthread_mutex_unlock(&an->lock);
+
+        // The slot is free: only this thread touches it until it is READY
+        if (!fgets(s->line, sizeof(s->line), in)) break;
+        s->tooLong = 0;
+        size_t len = strlen(s->line);
+        if (len > 0 && s->line[len - 1] != '\n' && !feof(in)) {
+            // Skip the rest of an over-long line
+            s->tooLong = 1;
+            while (fgets(buf, sizeof(buf), in) && buf[strlen(buf) - 1] != '\n') {}
+        }
+
+        pthread_mutex_lock(&an->lock);
+        s->state = SLOT_READY;
+        an->readCount++;
+        pthread_cond_signal(&an->workReady);
+        pthread_mutex_unlock(&an->lock);
+    }
+
+    pthread_mutex_lock(&an->lock);
+    an->eof = 1;
+    pthread_cond_broadcast(&an->workReady);
+    pthread_cond_signal(&an->slotDone);
+    pthread_mutex_unlock(&an->lock);
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s ENGINE [options]\n", prog);
+    printf("  ENGINE            minimax:D, solver or rl:PATH[:K]\n");
+    printf("  --in PATH         Positions, one move string per line (default stdin)\n");
+    printf("  --out PATH        Results, one line per position (default stdout)\n");
+    printf("  --threads N       Worker threads (default 1)\n");
+    printf("  --hash MB         Transposition table per worker in MB (default %d)\n", ANALYZE_HASH_MB);
+    printf("  --book PATH       Opening book file (default none)\n");
+    printf("  --seed N          Seed for tie-breaks (default 1)\n");
+    printf("  --help            Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    Analyzer an;
+    memset(&an, 0, sizeof(an));
+    const char *engineSpec = NULL;
+    const char *inPath = NULL;
+    const char *outPath = NULL;
+    const char *bookPath = NULL;
+    int threads = 1;
+    int hashMB = ANALYZE_HASH_MB;
+    int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--in") == 0 && i + 1 < argc) {
+            inPath = argv[++i];
+        } else if (strcmp(arg, "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &threads)) {
+            i++;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &hashMB)) {
+            i++;
+        } else if (strcmp(arg, "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seed)) {
+            i++;
+        } else if (arg[0] != '-' && !engineSpec) {
+            engineSpec = arg;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (!engineSpec) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (!parseEngine(engineSpec, &an)) {
+        fprintf(stderr, "Bad engine spec: %s\n", engineSpec);
+        return 1;
+    }
+    if (threads < 1) threads = 1;
+    if (threads > ANALYZE_MAX_THREADS) threads = ANALYZE_MAX_THREADS;
+    an.seed = (uint64_t)seed;
+
+    Book book;
+    memset(&book, 0, sizeof(book));
+    if (bookPath && strcmp(bookPath, "none") != 0) {
+        if (!bookOpen(&book, bookPath)) {
+            fprintf(stderr, "Could not open opening book %s\n", bookPath);
+            free(an.agent);
+            return 1;
+        }
+        an.book = &book;
+    }
+
+    FILE *in = inPath ? fopen(inPath, "r") : stdin;
+    if (!in) {
+        perror(inPath);
+        free(an.agent);
+        return 1;
+    }
+    an.out = outPath ? fopen(outPath, "w") : stdout;
+    if (!an.out) {
+        perror(outPath);
+        free(an.agent);
+        return 1;
+    }
+    an.slotCount = (size_t)threads * ANALYZE_SLOTS;
+    an.slots = calloc(an.slotCount, sizeof(Slot));
+    Worker *pool = calloc((size_t)threads, sizeof(Worker));
+    if (!an.slots || !pool) {
+        fprintf(stderr, "Out of memory\n");
+        free(an.agent);
+        return 1;
+    }
+
+    pthread_mutex_init(&an.lock, NULL);
+    pthread_cond_init(&an.workReady, NULL);
+    pthread_cond_init(&an.slotDone, NULL);
+    pthread_cond_init(&an.slotFree, NULL);
+
+    double start = timeNow();
+    pthread_t writer;
+    int ok = (pthread_create(&writer, NULL, writerMain, &an) == 0);
+    int started = 0;
+    for (int i = 0; ok && i < threads; i++) {
+        Worker *w = &pool[i];
+        w->an = &an;
+        initCPUEngine(&w->ctx);
+        setCPUDepth(&w->ctx, an.depth);
+        setCPUBook(&w->ctx, an.book);
+        if (!setCPUHashSize(&w->ctx, hashMB)) {
+            fprintf(stderr, "Could not allocate a %d MB transposition table.\n", hashMB);
+            freeCPUEngine(&w->ctx);
+            break;
+        }
+        if (pthread_create(&w->thread, NULL, workerMain, w) != 0) {
+            freeCPUEngine(&w->ctx);
+            break;
+        }
+        started++;
+    }
+
+    // Without every worker the input is not read; the writer still ends
+    if (started == threads) readInput(&an, in);
+    else {
+        pthread_mutex_lock(&an.lock);
+        an.eof = 1;
+        pthread_cond_broadcast(&an.workReady);
+        pthread_cond_signal(&an.slotDone);
+        pthread_mutex_unlock(&an.lock);
+    }
+
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool[i].thread, NULL);
+        freeCPUEngine(&pool[i].ctx);
+    }
+    if (ok) pthread_join(writer, NULL);
+    double secs = timeNow() - start;
+
+    if (started == threads) {
+        fprintf(stderr, "%llu positions in %.2f s (%.0f positions/s, %.0f nodes/s) on %d thread%s\n",
+                an.readCount, secs, (secs > 0.0) ? an.readCount / secs : 0.0,
+                (secs > 0.0) ? an.nodes / secs : 0.0, threads, threads == 1 ? "" : "s");
+    }
+
+    if (in != stdin) fclose(in);
+    if (an.out != stdout) fclose(an.out);
+    free(pool);
+    free(an.slots);
+    if (an.book) bookClose(&book);
+    free(an.agent);
+    return (started == threads) ? 0 : 1;
+}
@@ -0,0 +1,425 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "connect_four.h"
+#include "engine.h"
+#include "rl_agent.h"
+#include "timeutil.h"
+
+// =======================================================
+// Headless engine-vs-engine arena (c4_arena)
+// =======================================================
+//
+// Plays pairs of games between two engines: every pair starts from the
+// same random opening, once with each engine moving first. Pairs are
+// split over worker processes, each with its own copy of the engine
+// contexts; every game clears the hash tables and re-seeds both engines
+// from the seed and its index, so the results do not depend on the
+// number of workers.
+//
+// Engine specs:
+//   random               uniformly random legal move
+//   minimax:D            minimax CPU at depth D
+//   solver               exact solver ("Perfect" difficulty)
+//   rl:PATH[:K]          self-learning model file PATH, search depth K (3)
+
+#define ARENA_MAX_WORKERS 64
+#define RL_ARENA_DEPTH 3
+
+enum { ENGINE_RANDOM, ENGINE_MINIMAX, ENGINE_SOLVER, ENGINE_RL };
+
+typedef struct {
+    char     spec[256];
+    int      kind;
+    RLAgent *agent;
+    C4Engine ctx;      // depth, tables, random generator
+} Engine;
+
+// Per-engine totals; index 0 = first engine on the command line
+typedef struct {
+    long long wins;      // first engine's results
+    long long draws;
+    long long losses;
+    long long moves[2];
+    long long nodes[2];
+    double    ms[2];
+} ArenaStats;
+
+// ---------------- Engines ----------------
+
+static int parseEngine(const char *spec, Engine *e) {
+    memset(e, 0, sizeof(*e));
+    snprintf(e->spec, sizeof(e->spec), "%s", spec);
+    initCPUEngine(&e->ctx);
+
+    if (strcmp(spec, "random") == 0) {
+        e->kind = ENGINE_RANDOM;
+        return 1;
+    }
+    if (strcmp(spec, "solver") == 0) {
+        e->kind = ENGINE_SOLVER;
+        setCPUDepth(&e->ctx, 0);
+        return 1;
+    }
+    if (strncmp(spec, "minimax:", 8) == 0) {
+        char *end;
+        long depth = strtol(spec + 8, &end, 10);
+        if (end == spec + 8 || *end != '\0' || depth < 1 || depth > ROWS * COLS) return 0;
+        e->kind = ENGINE_MINIMAX;
+        setCPUDepth(&e->ctx, (int)depth);
+        return 1;
+    }
+    if (strncmp(spec, "rl:", 3) == 0) {
+        char path[256];
+        snprintf(path, sizeof(path), "%s", spec + 3);
+        e->kind = ENGINE_RL;
+        e->ctx.depth = RL_ARENA_DEPTH;
+
+        // Optional ":K" suffix (a path may contain ':' itself)
+        char *colon = strrchr(path, ':');
+        if (colon) {
+            char *end;
+            long depth = strtol(colon + 1, &end, 10);
+            if (end != colon + 1 && *end == '\0' && depth >= 1) {
+                e->ctx.depth = (int)depth;
+                *colon = '\0';
+            }
+        }
+
+        e->agent = malloc(sizeof(RLAgent));
+        if (!e->agent) return 0;
+        rl_init(e->agent);
+        if (!rl_load(e->agent, path)) {
+            fprintf(stderr, "Could not load model %s\n", path);
+            free(e->agent);
+            e->agent = NULL;
+            return 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+static int randomMove(Engine *e, char board[ROWS][COLS]) {
+    int valid[COLS];
+    int n = 0;
+    for (int c = 0; c < COLS; c++) {
+        if (isMoveValid(board, c)) valid[n++] = c;
+    }
+    return (n > 0) ? valid[rl_rng_next(&e->ctx.rng) % (uint32_t)n] : 0;
+}
+
+static int engineMove(Engine *e, char board[ROWS][COLS], char piece, long long *nodes) {
+    int move;
+    *nodes = 0;
+
+    switch (e->kind) {
+    case ENGINE_MINIMAX:
+    case ENGINE_SOLVER:
+        move = getCPUMove(&e->ctx, board, piece);
+        *nodes = e->ctx.stats.nodes;
+        return move;
+    case ENGINE_RL:
+        move = rl_choose_move(e->agent, &e->ctx, board, piece, 0.0);
+        *nodes = e->ctx.stats.nodes;
+        return move;
+    default:
+        return randomMove(e, board);
+    }
+}
+
+// ---------------- Games ----------------
+
+// Random opening of `plies` moves for pair `pair`; never a winning move.
+static void makeOpening(char board[ROWS][COLS], int plies, unsigned int seed, int pair) {
+    RLRng rng;
+    rl_rng_seed(&rng, ((uint64_t)seed << 32) ^ (uint64_t)pair);
+
+    initializeBoard(board);
+    char piece = PLAYER1;
+    for (int i = 0; i < plies; i++) {
+        int valid[COLS];
+        int n = 0;
+        for (int c = 0; c < COLS; c++) {
+            if (!isMoveValid(board, c)) continue;
+            char copy[ROWS][COLS];
+            memcpy(copy, board, sizeof(copy));
+            int r = dropPiece(copy, c, piece);
+            if (!checkWin(copy, piece, r, c)) valid[n++] = c;
+        }
+        if (n == 0) break;
+        dropPiece(board, valid[rl_rng_next(&rng) % (uint32_t)n], piece);
+        piece = (piece == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+}
+
+// Play one game from `opening`; engines[first] moves next. Returns the
+// index of the winning engine, or -1 for a draw.
+static int playGame(Engine engines[2], char opening[ROWS][COLS], int first, uint64_t seed,
+                    ArenaStats *st) {
+    char board[ROWS][COLS];
+    memcpy(board, opening, sizeof(board));
+
+    // Side to move follows from the stone count
+    int stones = 0;
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) stones += (board[r][c] != EMPTY);
+    }
+    char piece = (stones & 1) ? PLAYER2 : PLAYER1;
+    int turn = first;
+
+    // Search results of earlier games must not leak into this one
+    for (int i = 0; i < 2; i++) {
+        clearCPUHash(&engines[i].ctx);
+        seedCPUEngine(&engines[i].ctx, seed * 2 + (uint64_t)i);
+    }
+
+    while (!isBoardFull(board)) {
+        long long nodes;
+        double start = timeNow();
+        int col = engineMove(&engines[turn], board, piece, &nodes);
+        st->ms[turn] += (timeNow() - start) * 1000.0;
+        st->nodes[turn] += nodes;
+        st->moves[turn]++;
+
+        if (!isMoveValid(board, col)) return turn ^ 1;   // illegal move forfeits
+        int row = dropPiece(board, col, piece);
+        if (checkWin(board, piece, row, col)) return turn;
+
+        piece = (piece == PLAYER1) ? PLAYER2 : PLAYER1;
+        turn ^= 1;
+    }
+    return -1;
+}
+
+static void countResult(ArenaStats *st, int winner) {
+    if (winner == 0)      st->wins++;
+    else if (winner == 1) st->losses++;
+    else                  st->draws++;
+}
+
+// Play pairs worker, worker + workers, ... of `pairs`.
+static void playPairs(Engine engines[2], int pairs, int plies, unsigned int seed,
+                      int worker, int workers, ArenaStats *st) {
+    memset(st, 0, sizeof(*st));
+    for (int p = worker; p < pairs; p += workers) {
+        char opening[ROWS][COLS];
+        makeOpening(opening, plies, seed, p);
+        for (int first = 0; first < 2; first++) {
+            uint64_t gameSeed = (uint64_t)seed * 2654435761u + (uint64_t)(2 * p + first);
+            countResult(st, playGame(engines, opening, first, gameSeed, st));
+        }
+    }
+}
+
+static void addStats(ArenaStats *sum, const ArenaStats *st) {
+    sum->wins += st->wins;
+    sum->draws += st->draws;
+    sum->losses += st->losses;
+    for (int i = 0; i < 2; i++) {
+        sum->moves[i] += st->moves[i];
+        sum->nodes[i] += st->nodes[i];
+        sum->ms[i] += st->ms[i];
+    }
+}
+
+// Run the pairs on `workers` forked processes; 0 if a worker failed.
+static int runArena(Engine engines[2], int pairs, int plies, unsigned int seed,
+                    int workers, ArenaStats *total) {
+    memset(total, 0, sizeof(*total));
+#ifdef _WIN32
+    (void)workers;
+    playPairs(engines, pairs, plies, seed, 0, 1, total);
+    return 1;
+#else
+    if (workers <= 1) {
+        playPairs(engines, pairs, plies, seed, 0, 1, total);
+        return 1;
+    }
+
+    pid_t pids[ARENA_MAX_WORKERS];
+    int fds[ARENA_MAX_WORKERS];
+    int started = 0;
+    fflush(NULL);
+    for (int w = 0; w < workers; w++) {
+        int fd[2];
+        if (pipe(fd) != 0) break;
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fd[0]);
+            close(fd[1]);
+            break;
+        }
+        if (pid == 0) {
+            close(fd[0]);
+            ArenaStats st;
+            playPairs(engines, pairs, plies, seed, w, workers, &st);
+            int ok = write(fd[1], &st, sizeof(st)) == (ssize_t)sizeof(st);
+            _exit(ok ? 0 : 1);
+        }
+        close(fd[1]);
+        pids[started] = pid;
+        fds[started] = fd[0];
+        started++;
+    }
+
+    // Pairs of workers that never started are played here
+    for (int w = started; w < workers; w++) {
+        ArenaStats st;
+        playPairs(engines, pairs, plies, seed, w, workers, &st);
+        addStats(total, &st);
+    }
+
+    int ok = 1;
+    for (int w = 0; w < started; w++) {
+        ArenaStats st;
+        if (read(fds[w], &st, sizeof(st)) == (ssize_t)sizeof(st)) addStats(total, &st);
+        else ok = 0;
+        close(fds[w]);
+        int status = 0;
+        waitpid(pids[w], &status, 0);
+        if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) ok = 0;
+    }
+    return ok;
+#endif
+}
+
+// ---------------- Report ----------------
+
+static double eloFromScore(double p) {
+    if (p <= 0.0) return -INFINITY;
+    if (p >= 1.0) return INFINITY;
+    return -400.0 * log10(1.0 / p - 1.0);
+}
+
+static void printReport(Engine engines[2], const ArenaStats *st, double secs) {
+    long long n = st->wins + st->draws + st->losses;
+    if (n == 0) return;
+
+    double p = (st->wins + 0.5 * st->draws) / (double)n;
+    double var = (st->wins * (1.0 - p) * (1.0 - p) +
+                  st->draws * (0.5 - p) * (0.5 - p) +
+                  st->losses * p * p) / (double)n;
+    double margin = 1.96 * sqrt(var / (double)n);   // 95% on the mean score
+    double elo = eloFromScore(p);
+    double lo = eloFromScore(p - margin);
+    double hi = eloFromScore(p + margin);
+
+    printf("%s vs %s: %lld games in %.1f s\n", engines[0].spec, engines[1].spec, n, secs);
+    printf("  +%lld =%lld -%lld  score %.1f%%\n", st->wins, st->draws, st->losses, 100.0 * p);
+    if (isfinite(elo) && isfinite(lo) && isfinite(hi)) {
+        printf("  Elo %+.0f +- %.0f (95%%: %+.0f .. %+.0f)\n", elo, (hi - lo) / 2.0, lo, hi);
+    } else {
+        printf("  Elo %+.0f (95%%: %+.0f .. %+.0f)\n", elo, lo, hi);
+    }
+
+    printf("  %-32s %10s %10s %14s\n", "engine", "moves", "ms/move", "nodes/s");
+    for (int i = 0; i < 2; i++) {
+        double msPerMove = (st->moves[i] > 0) ? st->ms[i] / st->moves[i] : 0.0;
+        double nps = (st->ms[i] > 0.0) ? st->nodes[i] / (st->ms[i] / 1000.0) : 0.0;
+        printf("  %-32s %10lld %10.3f %14.0f\n", engines[i].spec, st->moves[i], msPerMove, nps);
+    }
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s ENGINE ENGINE [options]\n", prog);
+    printf("Engines: random, minimax:D, solver, rl:PATH[:K]\n");
+    printf("  --games N       Games to play, rounded up to pairs (default 1000)\n");
+    printf("  --threads N     Worker processes (default 1)\n");
+    printf("  --opening N     Random plies before the engines take over (default 2)\n");
+    printf("  --hash MB       CPU transposition table per engine and worker in MB (default 16)\n");
+    printf("  --seed N        Seed for openings and tie-breaks (default 1)\n");
+    printf("  --help          Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    const char *specs[2];
+    int nspecs = 0;
+    int games = 1000;
+    int workers = 1;
+    int plies = 2;
+    int hashMB = -1;
+    int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--games") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &games) && games > 0) {
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &workers)) {
+            i++;
+        } else if (strcmp(arg, "--opening") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &plies) && plies < ROWS * COLS) {
+            i++;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &hashMB)) {
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seed)) {
+            i++;
+        } else if (arg[0] != '-' && nspecs < 2) {
+            specs[nspecs++] = arg;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (nspecs != 2) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    if (workers < 1) workers = 1;
+    if (workers > ARENA_MAX_WORKERS) workers = ARENA_MAX_WORKERS;
+
+    Engine engines[2];
+    for (int i = 0; i < 2; i++) {
+        if (!parseEngine(specs[i], &engines[i])) {
+            fprintf(stderr, "Bad engine spec: %s\n", specs[i]);
+            return 1;
+        }
+    }
+    for (int i = 0; i < 2 && hashMB >= 0; i++) {
+        if (!setCPUHashSize(&engines[i].ctx, hashMB)) {
+            fprintf(stderr, "Could not allocate a %d MB transposition table.\n", hashMB);
+            return 1;
+        }
+    }
+
+    int pairs = (games + 1) / 2;
+    double start = timeNow();
+    ArenaStats total;
+    int ok = runArena(engines, pairs, plies, (unsigned int)seed, workers, &total);
+    printReport(engines, &total, timeNow() - start);
+
+    for (int i = 0; i < 2; i++) {
+        freeCPUEngine(&engines[i].ctx);
+        free(engines[i].agent);
+    }
+    if (!ok) {
+        fprintf(stderr, "A worker process failed; its games are missing.\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,310 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "connect_four.h"
+#include "engine.h"
+#include "bitboard.h"
+#include "rl_agent.h"
+#include "timeutil.h"
+
+// =======================================================
+// Benchmark suite (c4_bench, "make bench")
+// =======================================================
+//
+// Prints one JSON object per line so results can be collected and
+// compared across commits:
+//   perft       leaf count of the move tree to a depth, and nodes/s
+//   search      minimax on every position of bench/{early,middle,late}.txt
+//               at a fixed depth: nodes, time to depth, nodes/s per set
+//   eval        evaluations/s of the minimax leaf evaluation and of the
+//               RL feature extractor
+//   train       self-play games/s for the linear and N-tuple models
+// Searches use one thread, a cleared transposition table per position and
+// fixed seeds, so node counts are reproducible; only times vary.
+
+#define BENCH_MAX_POSITIONS 256
+
+typedef struct {
+    const char *name;
+    int         depth;     // default search depth for the set
+} BenchSet;
+
+static const BenchSet benchSets[] = {
+    {"early",  12},
+    {"middle", 14},
+    {"late",   16},
+};
+#define NUM_BENCH_SETS ((int)(sizeof(benchSets) / sizeof(benchSets[0])))
+
+typedef struct {
+    char board[ROWS][COLS];
+    char toMove;
+} BenchPosition;
+
+static const char *benchLabel = NULL;
+
+// Start a JSON line with the common fields.
+static void beginRecord(const char *bench) {
+    printf("{\"bench\":\"%s\"", bench);
+    if (benchLabel) printf(",\"label\":\"%s\"", benchLabel);
+}
+
+// ---------------- Positions ----------------
+
+// Play a line of columns 1-7 from the empty board. Returns 0 on an illegal
+// move or a line that ends the game.
+static int playLine(const char *line, BenchPosition *pos) {
+    initializeBoard(pos->board);
+    pos->toMove = PLAYER1;
+    for (const char *p = line; *p && *p != '\n' && *p != '\r'; p++) {
+        int c = *p - '1';
+        if (c < 0 || c >= COLS || !isMoveValid(pos->board, c)) return 0;
+        int r = dropPiece(pos->board, c, pos->toMove);
+        if (checkWin(pos->board, pos->toMove, r, c) || isBoardFull(pos->board)) return 0;
+        pos->toMove = (pos->toMove == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+    return 1;
+}
+
+// Read a position file: one move line per position, '#' starts a comment.
+// Returns the number of positions, or -1 if the file cannot be read.
+static int loadPositions(const char *path, BenchPosition *out, int max) {
+    FILE *fp = fopen(path, "r");
+    if (!fp) return -1;
+
+    char line[128];
+    int n = 0;
+    int lineNo = 0;
+    while (n < max && fgets(line, sizeof(line), fp)) {
+        lineNo++;
+        if (line[0] == '#' || line[0] == '\n' || line[0] == '\r') continue;
+        if (!playLine(line, &out[n])) {
+            fprintf(stderr, "%s:%d: illegal or finished line, skipped\n", path, lineNo);
+            continue;
+        }
+        n++;
+    }
+    fclose(fp);
+    return n;
+}
+
+// ---------------- perft ----------------
+
+static uint64_t perft(Bitboard *bb, int who, int depth) {
+    if (depth == 0) return 1;
+
+    uint64_t leaves = 0;
+    for (int c = 0; c < COLS; c++) {
+        if (!bbCanPlay(bb, c)) continue;
+        if (depth == 1 || bbIsWinningMove(bb, c, who)) {
+            leaves++;   // a win ends the line
+            continue;
+        }
+        bbPlay(bb, c, who);
+        leaves += perft(bb, who ^ 1, depth - 1);
+        bbUndo(bb, c, who);
+    }
+    return leaves;
+}
+
+static void benchPerft(int maxDepth) {
+    for (int depth = 1; depth <= maxDepth; depth++) {
+        Bitboard bb;
+        bbInit(&bb);
+        double start = timeNow();
+        uint64_t leaves = perft(&bb, 0, depth);
+        double secs = timeNow() - start;
+
+        beginRecord("perft");
+        printf(",\"depth\":%d,\"leaves\":%llu,\"ms\":%.3f,\"nps\":%.0f}\n",
+               depth, (unsigned long long)leaves, secs * 1000.0,
+               (secs > 0.0) ? leaves / secs : 0.0);
+    }
+}
+
+// ---------------- minimax ----------------
+
+static int benchSearch(const char *dir, const BenchSet *set, int depthDelta) {
+    static BenchPosition positions[BENCH_MAX_POSITIONS];
+    char path[512];
+    snprintf(path, sizeof(path), "%s/%s.txt", dir, set->name);
+
+    int n = loadPositions(path, positions, BENCH_MAX_POSITIONS);
+    if (n < 0) {
+        fprintf(stderr, "Could not read %s\n", path);
+        return 0;
+    }
+
+    int depth = set->depth + depthDelta;
+    if (depth < 1) depth = 1;
+    C4Engine engine;
+    initCPUEngine(&engine);
+    setCPUDepth(&engine, depth);
+
+    long long totalNodes = 0;
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    for (int i = 0; i < n; i++) {
+        clearCPUHash(&engine);
+        seedCPUEngine(&engine, 1);
+        getCPUMove(&engine, positions[i].board, positions[i].toMove);
+
+        long long nodes;
+        double ms;
+        getCPUSearchStats(&engine, &nodes, &ms);
+        totalNodes += nodes;
+        totalMs += ms;
+        if (ms > maxMs) maxMs = ms;
+    }
+    freeCPUEngine(&engine);
+
+    beginRecord("search");
+    printf(",\"set\":\"%s\",\"positions\":%d,\"depth\":%d,\"nodes\":%lld,"
+           "\"ms\":%.3f,\"ms_per_position\":%.3f,\"max_ms\":%.3f,\"nps\":%.0f}\n",
+           set->name, n, depth, totalNodes, totalMs, (n > 0) ? totalMs / n : 0.0, maxMs,
+           (totalMs > 0.0) ? totalNodes / (totalMs / 1000.0) : 0.0);
+    return 1;
+}
+
+// ---------------- Evaluation ----------------
+
+// Random, unfinished positions for the evaluation loops.
+static int randomPositions(BenchPosition *out, int count) {
+    srand(7);
+    int n = 0;
+    while (n < count) {
+        BenchPosition *pos = &out[n];
+        initializeBoard(pos->board);
+        pos->toMove = PLAYER1;
+        int stones = rand() % (ROWS * COLS - 6);
+        int ok = 1;
+        for (int k = 0; k < stones && ok; k++) {
+            int c = rand() % COLS;
+            if (!isMoveValid(pos->board, c)) continue;
+            int r = dropPiece(pos->board, c, pos->toMove);
+            if (checkWin(pos->board, pos->toMove, r, c)) ok = 0;
+            pos->toMove = (pos->toMove == PLAYER1) ? PLAYER2 : PLAYER1;
+        }
+        if (ok) n++;
+    }
+    return n;
+}
+
+static void benchEval(int reps) {
+    static BenchPosition positions[BENCH_MAX_POSITIONS];
+    int n = randomPositions(positions, BENCH_MAX_POSITIONS);
+    long long evals = (long long)n * reps;
+    C4Engine engine;
+    initCPUEngine(&engine);
+
+    // The sums keep the compiler from dropping the loops
+    long long sum = 0;
+    double start = timeNow();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < n; i++) sum += evaluateCPUPosition(&engine, positions[i].board, positions[i].toMove);
+    }
+    double secs = timeNow() - start;
+    beginRecord("eval");
+    printf(",\"function\":\"evaluateBoard\",\"evals\":%lld,\"ms\":%.3f,\"evals_per_sec\":%.0f,"
+           "\"checksum\":%lld}\n", evals, secs * 1000.0, (secs > 0.0) ? evals / secs : 0.0, sum);
+
+    double fsum = 0.0;
+    start = timeNow();
+    for (int r = 0; r < reps; r++) {
+        for (int i = 0; i < n; i++) {
+            double f[RL_FEATURES];
+            rl_extract_features(positions[i].board, positions[i].toMove, f);
+            fsum += f[1] + f[2] + f[10];
+        }
+    }
+    secs = timeNow() - start;
+    beginRecord("eval");
+    printf(",\"function\":\"extractFeatures\",\"evals\":%lld,\"ms\":%.3f,\"evals_per_sec\":%.0f,"
+           "\"checksum\":%.0f}\n", evals, secs * 1000.0, (secs > 0.0) ? evals / secs : 0.0, fsum);
+}
+
+// ---------------- Training ----------------
+
+static int benchTrain(int games) {
+    RLAgent *a = malloc(sizeof(*a));
+    if (!a) return 0;
+
+    for (int model = RL_MODEL_LINEAR; model <= RL_MODEL_NTUPLE; model++) {
+        if (model == RL_MODEL_NTUPLE) rl_init_ntuple(a);
+        else                          rl_init(a);
+
+        double start = timeNow();
+        rl_train_selfplay_mt(a, games, 1, 42);
+        double secs = timeNow() - start;
+
+        beginRecord("train");
+        printf(",\"model\":\"%s\",\"games\":%d,\"threads\":1,\"ms\":%.3f,\"games_per_sec\":%.0f}\n",
+               (model == RL_MODEL_NTUPLE) ? "ntuple" : "linear", games, secs * 1000.0,
+               (secs > 0.0) ? games / secs : 0.0);
+    }
+    free(a);
+    return 1;
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --quick         Smaller run: perft 8, search depths -2, fewer reps and games\n");
+    printf("  --only NAME     Run one part: perft, search, eval or train\n");
+    printf("  --positions DIR Position sets directory (default bench)\n");
+    printf("  --label TEXT    Add \"label\":TEXT to every line (e.g. a commit id)\n");
+    printf("  --help          Show this help\n");
+}
+
+int main(int argc, char **argv) {
+    const char *dir = "bench";
+    const char *only = NULL;
+    int quick = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--quick") == 0) {
+            quick = 1;
+        } else if (strcmp(arg, "--only") == 0 && i + 1 < argc) {
+            only = argv[++i];
+        } else if (strcmp(arg, "--positions") == 0 && i + 1 < argc) {
+            dir = argv[++i];
+        } else if (strcmp(arg, "--label") == 0 && i + 1 < argc) {
+            benchLabel = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (only && strcmp(only, "perft") != 0 && strcmp(only, "search") != 0 &&
+        strcmp(only, "eval") != 0 && strcmp(only, "train") != 0) {
+        fprintf(stderr, "Unknown benchmark: %s\n", only);
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    int status = 0;
+    if (!only || strcmp(only, "perft") == 0) {
+        benchPerft(quick ? 8 : 10);
+    }
+    if (!only || strcmp(only, "search") == 0) {
+        for (int i = 0; i < NUM_BENCH_SETS; i++) {
+            if (!benchSearch(dir, &benchSets[i], quick ? -2 : 0)) status = 1;
+        }
+    }
+    if (!only || strcmp(only, "eval") == 0) {
+        benchEval(quick ? 200 : 2000);
+    }
+    if (!only || strcmp(only, "train") == 0) {
+        if (!benchTrain(quick ? 5000 : 50000)) status = 1;
+    }
+    fflush(stdout);
+    return status;
+}
@@ -0,0 +1,40 @@
+#include <string.h>
+#include "bitboard.h"
+
+void bbInit(Bitboard *bb) {
+    memset(bb, 0, sizeof(*bb));
+}
+
+// Build a bitboard from the char board used by the game loop.
+void bbFromBoard(Bitboard *bb, char board[ROWS][COLS]) {
+    bbInit(bb);
+    for (int c = 0; c < COLS; c++) {
+        for (int r = ROWS - 1; r >= 0; r--) {
+            char cell = board[r][c];
+            if (cell == EMPTY) break;
+            bb->pieces[bbIndex(cell)] |= bbCellBit(r, c);
+            bb->height[c]++;
+            bb->moves++;
+        }
+    }
+}
+
+void bbToBoard(const Bitboard *bb, char board[ROWS][COLS]) {
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            uint64_t bit = bbCellBit(r, c);
+            if (bb->pieces[0] & bit)      board[r][c] = PLAYER1;
+            else if (bb->pieces[1] & bit) board[r][c] = PLAYER2;
+            else                          board[r][c] = EMPTY;
+        }
+    }
+}
+
+// Count how many different columns would win immediately for `who`.
+int bbCountWinningMoves(const Bitboard *bb, int who) {
+    int count = 0;
+    for (int c = 0; c < COLS; c++) {
+        if (bbCanPlay(bb, c) && bbIsWinningMove(bb, c, who)) count++;
+    }
+    return count;
+}
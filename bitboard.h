@@ -0,0 +1,169 @@
+#ifndef BITBOARD_H
+#define BITBOARD_H
+
+#include <stdint.h>
+#include "connect_four.h"
+
+// =======================================================
+// Bitboard position core
+// =======================================================
+//
+// Bit layout (column-major, one spare sentinel bit on top of each column):
+//
+//   6 13 20 27 34 41 48   <- sentinel row, always empty
+//   5 12 19 26 33 40 47   <- top row    (board[0][c])
+//   4 11 18 25 32 39 46
+//   3 10 17 24 31 38 45
+//   2  9 16 23 30 37 44
+//   1  8 15 22 29 36 43
+//   0  7 14 21 28 35 42   <- bottom row (board[ROWS-1][c])
+//
+// The sentinel bit keeps shifts from carrying a line over into the next
+// column, so a single shift-and-AND detects four in a row.
+
+#define BB_HEIGHT (ROWS + 1)
+
+_Static_assert(COLS == 7 && ROWS == 6, "bitboard masks assume the standard 7x6 board");
+
+// Bit for the bottom cell of each column
+#define BB_BOTTOM_MASK  0x0000040810204081ULL
+// All playable (non-sentinel) cells
+#define BB_BOARD_MASK   (BB_BOTTOM_MASK * ((1ULL << ROWS) - 1))
+// All cells of one column
+#define BB_COLUMN_MASK(c) (((1ULL << ROWS) - 1) << ((c) * BB_HEIGHT))
+
+typedef struct {
+    uint64_t pieces[2];     // [0] = PLAYER1 stones, [1] = PLAYER2 stones
+    uint8_t  height[COLS];  // stones currently in each column
+    int      moves;         // stones on the board
+} Bitboard;
+
+// 0 for PLAYER1, 1 for PLAYER2
+static inline int bbIndex(char piece) {
+    return (piece == PLAYER2) ? 1 : 0;
+}
+
+static inline uint64_t bbCellBit(int row, int col) {
+    // row is in board[][] orientation (0 = top)
+    return 1ULL << (col * BB_HEIGHT + (ROWS - 1 - row));
+}
+
+static inline int bbPopcount(uint64_t x) {
+    return __builtin_popcountll(x);
+}
+
+static inline uint64_t bbOccupied(const Bitboard *bb) {
+    return bb->pieces[0] | bb->pieces[1];
+}
+
+// Cells a stone could be dropped into right now (one per non-full column).
+static inline uint64_t bbPlayableCells(const Bitboard *bb) {
+    return (bbOccupied(bb) + BB_BOTTOM_MASK) & BB_BOARD_MASK;
+}
+
+static inline int bbCanPlay(const Bitboard *bb, int col) {
+    return col >= 0 && col < COLS && bb->height[col] < ROWS;
+}
+
+// Row (board[][] orientation) a piece dropped into col would land on.
+static inline int bbLandingRow(const Bitboard *bb, int col) {
+    return ROWS - 1 - bb->height[col];
+}
+
+// Drop a stone for player `who` (0/1). Caller checks bbCanPlay first.
+static inline void bbPlay(Bitboard *bb, int col, int who) {
+    bb->pieces[who] |= 1ULL << (col * BB_HEIGHT + bb->height[col]);
+    bb->height[col]++;
+    bb->moves++;
+}
+
+// Take back the top stone of col (it must belong to `who`).
+static inline void bbUndo(Bitboard *bb, int col, int who) {
+    bb->height[col]--;
+    bb->moves--;
+    bb->pieces[who] &= ~(1ULL << (col * BB_HEIGHT + bb->height[col]));
+}
+
+// Four in a row anywhere in a single player's stone mask.
+static inline int bbIsWin(uint64_t p) {
+    uint64_t m;
+
+    // Vertical
+    m = p & (p >> 1);
+    if (m & (m >> 2)) return 1;
+
+    // Horizontal
+    m = p & (p >> BB_HEIGHT);
+    if (m & (m >> (2 * BB_HEIGHT))) return 1;
+
+    // Diagonal (down-right in board[][] orientation)
+    m = p & (p >> (BB_HEIGHT - 1));
+    if (m & (m >> (2 * (BB_HEIGHT - 1)))) return 1;
+
+    // Diagonal (up-right in board[][] orientation)
+    m = p & (p >> (BB_HEIGHT + 1));
+    if (m & (m >> (2 * (BB_HEIGHT + 1)))) return 1;
+
+    return 0;
+}
+
+static inline int bbHasWon(const Bitboard *bb, int who) {
+    return bbIsWin(bb->pieces[who]);
+}
+
+// Would dropping a stone for `who` into col win on the spot?
+static inline int bbIsWinningMove(const Bitboard *bb, int col, int who) {
+    uint64_t p = bb->pieces[who] | (1ULL << (col * BB_HEIGHT + bb->height[col]));
+    return bbIsWin(p);
+}
+
+// Empty cells that would complete a four for the stones in `position`.
+static inline uint64_t bbWinningCells(uint64_t position, uint64_t mask) {
+    // Vertical
+    uint64_t r = (position << 1) & (position << 2) & (position << 3);
+    uint64_t p;
+
+    // Horizontal
+    p = (position << BB_HEIGHT) & (position << 2 * BB_HEIGHT);
+    r |= p & (position << 3 * BB_HEIGHT);
+    r |= p & (position >> BB_HEIGHT);
+    p = (position >> BB_HEIGHT) & (position >> 2 * BB_HEIGHT);
+    r |= p & (position << BB_HEIGHT);
+    r |= p & (position >> 3 * BB_HEIGHT);
+
+    // Diagonal 1
+    p = (position << (BB_HEIGHT - 1)) & (position << 2 * (BB_HEIGHT - 1));
+    r |= p & (position << 3 * (BB_HEIGHT - 1));
+    r |= p & (position >> (BB_HEIGHT - 1));
+    p = (position >> (BB_HEIGHT - 1)) & (position >> 2 * (BB_HEIGHT - 1));
+    r |= p & (position << (BB_HEIGHT - 1));
+    r |= p & (position >> 3 * (BB_HEIGHT - 1));
+
+    // Diagonal 2
+    p = (position << (BB_HEIGHT + 1)) & (position << 2 * (BB_HEIGHT + 1));
+    r |= p & (position << 3 * (BB_HEIGHT + 1));
+    r |= p & (position >> (BB_HEIGHT + 1));
+    p = (position >> (BB_HEIGHT + 1)) & (position >> 2 * (BB_HEIGHT + 1));
+    r |= p & (position << (BB_HEIGHT + 1));
+    r |= p & (position >> 3 * (BB_HEIGHT + 1));
+
+    return r & (BB_BOARD_MASK ^ mask);
+}
+
+static inline int bbIsFull(const Bitboard *bb) {
+    return bb->moves >= ROWS * COLS;
+}
+
+// Unique 64-bit key of the stones on the board. Adding the bottom row to the
+// occupancy mask sets the bit just above each column's top stone, so the sum
+// with one player's stones identifies the position exactly.
+static inline uint64_t bbKey(const Bitboard *bb) {
+    return bb->pieces[0] + bbOccupied(bb) + BB_BOTTOM_MASK;
+}
+
+void bbInit(Bitboard *bb);
+void bbFromBoard(Bitboard *bb, char board[ROWS][COLS]);
+void bbToBoard(const Bitboard *bb, char board[ROWS][COLS]);
+int  bbCountWinningMoves(const Bitboard *bb, int who);
+
+#endif
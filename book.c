@@ -0,0 +1,127 @@
+#include <string.h>
+#include "book.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+static const int bookOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+int bookOpen(Book *book, const char *path) {
+    memset(book, 0, sizeof(*book));
+#ifdef _WIN32
+    (void)path;
+    return 0;   // no mmap on Windows builds; play without a book
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(BookHeader)) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping stays valid
+    if (map == MAP_FAILED) return 0;
+
+    const BookHeader *h = (const BookHeader *)map;
+    if (memcmp(h->magic, BOOK_MAGIC, 4) != 0 || h->version != BOOK_VERSION ||
+        h->count > (size - sizeof(BookHeader)) / sizeof(uint64_t)) {
+        munmap(map, size);
+        return 0;
+    }
+
+    book->map = map;
+    book->mapSize = size;
+    book->entries = (const uint64_t *)((const char *)map + sizeof(BookHeader));
+    book->count = h->count;
+    book->maxPly = (int)h->maxPly;
+    return 1;
+#endif
+}
+
+void bookClose(Book *book) {
+#ifndef _WIN32
+    if (book->map) munmap(book->map, book->mapSize);
+#endif
+    memset(book, 0, sizeof(*book));
+}
+
+// Reverse the column order of a bitboard.
+static uint64_t mirrorColumns(uint64_t x) {
+    uint64_t r = 0;
+    for (int c = 0; c < COLS; c++) {
+        uint64_t col = (x >> (c * BB_HEIGHT)) & ((1ULL << BB_HEIGHT) - 1);
+        r |= col << ((COLS - 1 - c) * BB_HEIGHT);
+    }
+    return r;
+}
+
+uint64_t bookCanonicalKey(uint64_t current, uint64_t mask) {
+    // Per column the sum stays below the column's sentinel bit, so the
+    // mirror of the key is the key of the mirrored position.
+    uint64_t key = current + mask + BB_BOTTOM_MASK;
+    uint64_t mirrored = mirrorColumns(key);
+    return (mirrored < key) ? mirrored : key;
+}
+
+uint64_t bookPositionKey(const Bitboard *bb, int who) {
+    return bookCanonicalKey(bb->pieces[who], bbOccupied(bb));
+}
+
+static int lookupKey(const Book *book, uint64_t key, int *score) {
+    uint64_t lo = 0, hi = book->count;
+    while (lo < hi) {
+        uint64_t mid = lo + (hi - lo) / 2;
+        uint64_t k = book->entries[mid] >> 8;
+        if (k < key)      lo = mid + 1;
+        else if (k > key) hi = mid;
+        else {
+            *score = (int)(int8_t)(uint8_t)(book->entries[mid] & 0xff);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int bookProbe(const Book *book, const Bitboard *bb, int who, int *score) {
+    if (!book || !book->entries || bb->moves > book->maxPly) return 0;
+    return lookupKey(book, bookPositionKey(bb, who), score);
+}
+
+int bookBestMove(const Book *book, const Bitboard *bb, int who, int *score) {
+    if (!book || !book->entries || bb->moves >= book->maxPly) return -1;
+
+    int best = -1;
+    int bestScore = 0;
+
+    for (int i = 0; i < COLS; i++) {
+        int c = bookOrder[i];
+        if (!bbCanPlay(bb, c)) continue;
+
+        int s;
+        if (bbIsWinningMove(bb, c, who)) {
+            s = (ROWS * COLS + 1 - bb->moves) / 2;
+        } else {
+            Bitboard child = *bb;
+            bbPlay(&child, c, who);
+            int childScore;
+            if (!bookProbe(book, &child, who ^ 1, &childScore)) return -1;
+            s = -childScore;
+        }
+
+        if (best < 0 || s > bestScore) {
+            best = c;
+            bestScore = s;
+        }
+    }
+
+    if (best >= 0 && score) *score = bestScore;
+    return best;
+}
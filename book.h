@@ -0,0 +1,63 @@
+#ifndef BOOK_H
+#define BOOK_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include "bitboard.h"
+
+// =======================================================
+// Memory-mapped opening book
+// =======================================================
+//
+// File layout (native byte order, all fields 8-byte aligned):
+//   char     magic[4]    "C4BK"
+//   uint32_t version     (1)
+//   uint32_t maxPly      positions with up to maxPly stones are included
+//   uint32_t reserved
+//   uint64_t count
+//   uint64_t entries[count], sorted ascending:
+//            (canonical position key << 8) | (uint8_t)score
+//
+// Keys are bbKey-style (stones of the side to move + occupancy + bottom
+// row), canonicalised as the smaller of the key and its mirror image.
+// Scores use the solver's scale, from the side to move's point of view.
+// The file is mmap'ed read-only; lookups are a binary search, nothing is
+// parsed or copied to the heap.
+
+#define BOOK_MAGIC   "C4BK"
+#define BOOK_VERSION 1
+#define BOOK_PATH_DEFAULT "c4_book.bin"
+
+typedef struct Book {
+    const uint64_t *entries;
+    uint64_t        count;
+    int             maxPly;
+
+    void           *map;      // whole file mapping
+    size_t          mapSize;
+} Book;
+
+typedef struct {
+    char     magic[4];
+    uint32_t version;
+    uint32_t maxPly;
+    uint32_t reserved;
+    uint64_t count;
+} BookHeader;
+
+// Map a book file. Returns 1 on success, 0 if missing or invalid.
+int  bookOpen(Book *book, const char *path);
+void bookClose(Book *book);
+
+// Canonical key of the position with `who` (0/1) to move.
+uint64_t bookCanonicalKey(uint64_t current, uint64_t mask);
+uint64_t bookPositionKey(const Bitboard *bb, int who);
+
+// Exact score of a position stored in the book (1 if found).
+int  bookProbe(const Book *book, const Bitboard *bb, int who, int *score);
+
+// Best column for `who` according to the book, or -1 if the position's
+// children are not all covered. Ties go to the column nearest the center.
+int  bookBestMove(const Book *book, const Bitboard *bb, int who, int *score);
+
+#endif
@@ -0,0 +1,401 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "connect_four.h"
+#include "bitboard.h"
+#include "solver.h"
+#include "book.h"
+#include "timeutil.h"
+
+// =======================================================
+// Offline opening-book generator (c4_bookgen)
+// =======================================================
+//
+// 1. Enumerate every position reachable from the root with up to --ply
+//    stones, deduplicated by mirror-canonical key. Positions where the
+//    game is already over are not stored.
+// 2. Solve the positions at the last ply exactly (in parallel).
+// 3. Back the scores up ply by ply with plain negamax over the children,
+//    which needs no search at all.
+// 4. Write the sorted (key, score) entries in the format read by book.c.
+
+#define GEN_MAX_THREADS 64
+#define SCORE_UNKNOWN   127
+
+// A position as "stones of the side to move + all stones".
+typedef struct {
+    uint64_t current;
+    uint64_t mask;
+} GenPos;
+
+typedef struct {
+    GenPos *pos;
+    size_t  count;
+    size_t  cap;
+} PosList;
+
+// Open-addressing map: canonical key -> score. Keys are never 0.
+typedef struct {
+    uint64_t *keys;
+    int8_t   *scores;
+    size_t    cap;      // power of two
+    size_t    count;
+} ScoreMap;
+
+static int mapInit(ScoreMap *m, size_t cap) {
+    m->cap = cap;
+    m->count = 0;
+    m->keys = calloc(cap, sizeof(*m->keys));
+    m->scores = malloc(cap * sizeof(*m->scores));
+    return m->keys && m->scores;
+}
+
+static void mapFree(ScoreMap *m) {
+    free(m->keys);
+    free(m->scores);
+    memset(m, 0, sizeof(*m));
+}
+
+static size_t mapSlot(const ScoreMap *m, uint64_t key) {
+    size_t i = (size_t)((key * 0x9E3779B97F4A7C15ULL) >> 20) & (m->cap - 1);
+    while (m->keys[i] != 0 && m->keys[i] != key) i = (i + 1) & (m->cap - 1);
+    return i;
+}
+
+static int mapGrow(ScoreMap *m) {
+    ScoreMap bigger;
+    if (!mapInit(&bigger, m->cap * 2)) return 0;
+    for (size_t i = 0; i < m->cap; i++) {
+        if (m->keys[i] == 0) continue;
+        size_t j = mapSlot(&bigger, m->keys[i]);
+        bigger.keys[j] = m->keys[i];
+        bigger.scores[j] = m->scores[i];
+        bigger.count++;
+    }
+    mapFree(m);
+    *m = bigger;
+    return 1;
+}
+
+// Returns 1 if the key was new, 0 if already present, -1 out of memory.
+static int mapInsert(ScoreMap *m, uint64_t key, int score) {
+    if ((m->count + 1) * 2 > m->cap && !mapGrow(m)) return -1;
+    size_t i = mapSlot(m, key);
+    if (m->keys[i] == key) return 0;
+    m->keys[i] = key;
+    m->scores[i] = (int8_t)score;
+    m->count++;
+    return 1;
+}
+
+static int8_t *mapFind(ScoreMap *m, uint64_t key) {
+    size_t i = mapSlot(m, key);
+    return (m->keys[i] == key) ? &m->scores[i] : NULL;
+}
+
+static int listPush(PosList *l, GenPos p) {
+    if (l->count == l->cap) {
+        size_t cap = l->cap ? l->cap * 2 : 1024;
+        GenPos *grown = realloc(l->pos, cap * sizeof(*grown));
+        if (!grown) return 0;
+        l->pos = grown;
+        l->cap = cap;
+    }
+    l->pos[l->count++] = p;
+    return 1;
+}
+
+static uint64_t genKey(const GenPos *p) {
+    return bookCanonicalKey(p->current, p->mask);
+}
+
+static uint64_t landingBit(uint64_t mask, int col) {
+    return (mask + BB_BOTTOM_MASK) & BB_COLUMN_MASK(col);
+}
+
+static void genPlay(const GenPos *p, int col, GenPos *child) {
+    child->current = p->current ^ p->mask;
+    child->mask = p->mask | landingBit(p->mask, col);
+}
+
+static int genIsWinningMove(const GenPos *p, int col) {
+    return bbIsWin(p->current | landingBit(p->mask, col));
+}
+
+static void genToBitboard(const GenPos *p, Bitboard *bb) {
+    bbInit(bb);
+    bb->pieces[0] = p->current;
+    bb->pieces[1] = p->current ^ p->mask;
+    for (int c = 0; c < COLS; c++) {
+        bb->height[c] = (uint8_t)bbPopcount(p->mask & BB_COLUMN_MASK(c));
+    }
+    bb->moves = bbPopcount(p->mask);
+}
+
+// ---------------- Parallel leaf solving ----------------
+
+typedef struct {
+    const PosList *leaves;
+    int8_t        *scores;
+    atomic_size_t *next;
+    atomic_size_t *done;
+    size_t         hashMB;
+    double         start;
+    int            ok;
+} SolveJob;
+
+static void *solveWorker(void *arg) {
+    SolveJob *job = arg;
+    Solver solver;
+    if (!solverInit(&solver, job->hashMB)) return NULL;
+
+    size_t total = job->leaves->count;
+    size_t step = total / 100 + 1;
+    for (;;) {
+        size_t i = atomic_fetch_add(job->next, 1);
+        if (i >= total) break;
+
+        Bitboard bb;
+        genToBitboard(&job->leaves->pos[i], &bb);
+        job->scores[i] = (int8_t)solverSolve(&solver, &bb, 0, 0);
+
+        size_t done = atomic_fetch_add(job->done, 1) + 1;
+        if (done % step == 0 || done == total) {
+            fprintf(stderr, "\r  solved %zu / %zu (%.0f s)", done, total,
+                    timeNow() - job->start);
+        }
+    }
+
+    solverFree(&solver);
+    job->ok = 1;
+    return NULL;
+}
+
+static int solveLeaves(const PosList *leaves, int8_t *scores, int threads, size_t hashMB) {
+    atomic_size_t next, done;
+    atomic_init(&next, 0);
+    atomic_init(&done, 0);
+
+    SolveJob jobs[GEN_MAX_THREADS];
+    pthread_t tids[GEN_MAX_THREADS];
+    int started = 0;
+    double start = timeNow();
+
+    for (int t = 0; t < threads; t++) {
+        jobs[t] = (SolveJob){ leaves, scores, &next, &done, hashMB, start, 0 };
+        if (pthread_create(&tids[t], NULL, solveWorker, &jobs[t]) != 0) break;
+        started++;
+    }
+    if (started == 0) {
+        // No threads available: solve on this one
+        jobs[0] = (SolveJob){ leaves, scores, &next, &done, hashMB, start, 0 };
+        solveWorker(&jobs[0]);
+        started = 1;
+    } else {
+        for (int t = 0; t < started; t++) pthread_join(tids[t], NULL);
+    }
+    if (leaves->count > 0) fprintf(stderr, "\n");
+
+    // Every index must have been claimed by a worker that ran to completion.
+    int anyOk = 0;
+    for (int t = 0; t < started; t++) anyOk |= jobs[t].ok;
+    return anyOk && atomic_load(&done) == leaves->count;
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --ply N         Include positions with up to N stones (default 8)\n");
+    printf("  --root MOVES    Only build the book below this line, e.g. 4453 (columns 1-7)\n");
+    printf("  --threads N     Solver threads (default 1)\n");
+    printf("  --hash MB       Solver table size per thread in MB (default %d)\n",
+           SOLVER_HASH_MB_DEFAULT);
+    printf("  --out PATH      Output file (default %s)\n", BOOK_PATH_DEFAULT);
+    printf("  --help          Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+// Play the --root line from the empty board. Returns 0 on an illegal line.
+static int parseRoot(const char *moves, GenPos *root) {
+    root->current = 0;
+    root->mask = 0;
+    for (const char *m = moves; *m; m++) {
+        int col = *m - '1';
+        if (col < 0 || col >= COLS) return 0;
+        if (root->mask & BB_COLUMN_MASK(col) & (BB_BOTTOM_MASK << (ROWS - 1))) return 0;
+        if (genIsWinningMove(root, col)) return 0;   // game would be over
+        GenPos child;
+        genPlay(root, col, &child);
+        *root = child;
+    }
+    return 1;
+}
+
+static int compareEntries(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t *)a;
+    uint64_t y = *(const uint64_t *)b;
+    return (x > y) - (x < y);
+}
+
+static int writeBook(const char *path, const ScoreMap *map, int maxPly) {
+    uint64_t *entries = malloc((map->count ? map->count : 1) * sizeof(*entries));
+    if (!entries) return 0;
+
+    size_t n = 0;
+    for (size_t i = 0; i < map->cap; i++) {
+        if (map->keys[i] == 0) continue;
+        entries[n++] = (map->keys[i] << 8) | (uint8_t)map->scores[i];
+    }
+    qsort(entries, n, sizeof(*entries), compareEntries);
+
+    BookHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, BOOK_MAGIC, 4);
+    h.version = BOOK_VERSION;
+    h.maxPly = (uint32_t)maxPly;
+    h.count = n;
+
+    FILE *f = fopen(path, "wb");
+    int ok = f != NULL;
+    if (ok) ok = fwrite(&h, sizeof(h), 1, f) == 1;
+    if (ok && n > 0) ok = fwrite(entries, sizeof(*entries), n, f) == n;
+    if (f && fclose(f) != 0) ok = 0;
+
+    free(entries);
+    return ok;
+}
+
+int main(int argc, char **argv) {
+    int maxPly = 8;
+    int threads = 1;
+    int hashMB = SOLVER_HASH_MB_DEFAULT;
+    const char *rootMoves = "";
+    const char *outPath = BOOK_PATH_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--ply") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &maxPly) && maxPly <= ROWS * COLS) {
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &threads)) {
+            i++;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &hashMB) && hashMB > 0) {
+            i++;
+        } else if (strcmp(arg, "--root") == 0 && i + 1 < argc) {
+            rootMoves = argv[++i];
+        } else if (strcmp(arg, "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > GEN_MAX_THREADS) threads = GEN_MAX_THREADS;
+
+    GenPos root;
+    if (!parseRoot(rootMoves, &root)) {
+        fprintf(stderr, "Illegal --root line: %s\n", rootMoves);
+        return 1;
+    }
+    int rootPly = bbPopcount(root.mask);
+    if (maxPly < rootPly) {
+        fprintf(stderr, "--ply %d is shallower than the root line (%d stones)\n", maxPly, rootPly);
+        return 1;
+    }
+
+    // 1. Enumerate unique positions ply by ply
+    PosList plies[ROWS * COLS + 1];
+    memset(plies, 0, sizeof(plies));
+    ScoreMap map;
+    if (!mapInit(&map, 1 << 16)) goto oom;
+
+    if (mapInsert(&map, genKey(&root), SCORE_UNKNOWN) < 0 || !listPush(&plies[rootPly], root)) goto oom;
+    for (int ply = rootPly; ply < maxPly; ply++) {
+        for (size_t i = 0; i < plies[ply].count; i++) {
+            GenPos p = plies[ply].pos[i];
+            for (int c = 0; c < COLS; c++) {
+                if (!(landingBit(p.mask, c) & BB_BOARD_MASK)) continue;   // column full
+                if (genIsWinningMove(&p, c)) continue;                    // game over
+
+                GenPos child;
+                genPlay(&p, c, &child);
+                int fresh = mapInsert(&map, genKey(&child), SCORE_UNKNOWN);
+                if (fresh < 0) goto oom;
+                if (fresh && !listPush(&plies[ply + 1], child)) goto oom;
+            }
+        }
+        fprintf(stderr, "ply %2d: %zu positions\n", ply + 1, plies[ply + 1].count);
+    }
+
+    // 2. Solve the deepest ply exactly
+    fprintf(stderr, "Solving %zu positions at ply %d with %d thread%s...\n",
+            plies[maxPly].count, maxPly, threads, threads == 1 ? "" : "s");
+    {
+        PosList *leaves = &plies[maxPly];
+        int8_t *scores = malloc((leaves->count ? leaves->count : 1) * sizeof(*scores));
+        if (!scores) goto oom;
+        if (!solveLeaves(leaves, scores, threads, (size_t)hashMB)) {
+            free(scores);
+            goto oom;
+        }
+        for (size_t i = 0; i < leaves->count; i++) {
+            *mapFind(&map, genKey(&leaves->pos[i])) = scores[i];
+        }
+        free(scores);
+    }
+
+    // 3. Back up scores towards the root
+    for (int ply = maxPly - 1; ply >= rootPly; ply--) {
+        for (size_t i = 0; i < plies[ply].count; i++) {
+            GenPos p = plies[ply].pos[i];
+            int best = -ROWS * COLS;
+            for (int c = 0; c < COLS; c++) {
+                if (!(landingBit(p.mask, c) & BB_BOARD_MASK)) continue;
+                int s;
+                if (genIsWinningMove(&p, c)) {
+                    s = (ROWS * COLS + 1 - ply) / 2;
+                } else {
+                    GenPos child;
+                    genPlay(&p, c, &child);
+                    s = -*mapFind(&map, genKey(&child));
+                }
+                if (s > best) best = s;
+            }
+            *mapFind(&map, genKey(&p)) = (int8_t)best;
+        }
+    }
+
+    // 4. Write the sorted book
+    if (!writeBook(outPath, &map, maxPly)) {
+        fprintf(stderr, "Could not write %s\n", outPath);
+        return 1;
+    }
+    printf("Wrote %zu positions (ply %d..%d) to %s, root score %d\n",
+           map.count, rootPly, maxPly, outPath, *mapFind(&map, genKey(&root)));
+
+    for (int ply = 0; ply <= ROWS * COLS; ply++) free(plies[ply].pos);
+    mapFree(&map);
+    return 0;
+
+oom:
+    fprintf(stderr, "Out of memory\n");
+    return 1;
+}
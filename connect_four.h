@@ -15,18 +15,9 @@ void initializeBoard(char board[ROWS][COLS]);
 int  dropPiece(char board[ROWS][COLS], int col, char piece);
 int  checkWin(char board[ROWS][COLS], char piece, int last_row, int last_col);
 int  isBoardFull(char board[ROWS][COLS]);
-
-// -------- I/O + display + CPU (io_engine.c) --------
-void displayBoard(char board[ROWS][COLS]);
-void displayBoardWin(char board[ROWS][COLS], char winner, int last_row, int last_col);
-int  getHumanMove(char board[ROWS][COLS], char piece);
-int  getCPUMove(char board[ROWS][COLS], char piece);
 int  isMoveValid(char board[ROWS][COLS], int col);
-int  selectGameMode(void);
-int  selectColorMode(void);
-int promptTrainingGames(void);
 
-// lets the user choose CPU difficulty (depth)
-int  selectCPUDifficulty(void);
+// The CPU engines are declared in engine.h and rl_agent.h, the console
+// game's input and display in console.h.
 
 #endif
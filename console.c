@@ -0,0 +1,361 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "console.h"
+#include "windows.h"
+
+// =======================================================
+// Console input + display (interactive game)
+// =======================================================
+
+// Simple ANSI color codes
+#define CLR_RESET        "\x1b[0m"
+#define CLR_P1           "\x1b[31m"  // red for PLAYER1
+#define CLR_P2           "\x1b[34m"  // blue for PLAYER2
+#define CLR_THREAT_EMPTY "\x1b[33m"  // yellow for empty threat cells
+#define CLR_RESET "\x1b[0m"
+#define CLR_WIN   "\x1b[32m" 
+
+
+// ---------- SAFE INTEGER INPUT ----------
+
+static int readInt(const char *prompt, int *out) {
+    char buf[128];
+
+    printf("%s", prompt);
+    if (!fgets(buf, sizeof(buf), stdin)) return 0;
+
+    char *p = buf;
+    while (isspace((unsigned char)*p)) p++;
+
+    char *endptr;
+    long val = strtol(p, &endptr, 10);
+
+    if (p == endptr) return 0;
+
+    while (isspace((unsigned char)*endptr)) endptr++;
+    if (*endptr != '\0') return 0;
+
+    *out = (int)val;
+    return 1;
+}
+
+// ---------- COLOR MODE SELECTION ----------
+
+int selectColorMode(void) {
+    int choice = 0;
+    while (choice != 1 && choice != 2) {
+        printf("\nColor mode:\n");
+        printf("1) Off (plain board)\n");
+        printf("2) On  (show threats in color)\n");
+        if (!readInt("Choice: ", &choice)) {
+            printf("Invalid input. Please enter 1 or 2.\n");
+        }
+    }
+    int color = (choice == 2);
+    printf("Color mode %s.\n", color ? "ON" : "OFF");
+    return color;
+}
+
+
+// ---------- MODE SELECTION ----------
+
+int selectGameMode(void) {
+    int mode = 0;
+    while (mode < 1 || mode > 4) {
+        printf("\nSelect mode:\n");
+        printf("1) Human vs Human\n");
+        printf("2) Human vs CPU (minimax)\n");
+        printf("3) Human vs Self-Learning AI\n");
+        printf("4) Train Self-Learning AI (self-play)\n");
+
+        if (!readInt("Choice: ", &mode)) {
+            printf("Invalid input. Please enter 1, 2, 3, or 4.\n");
+            mode = 0;
+        }
+    }
+    return mode;
+}
+
+
+// ---------- CPU DIFFICULTY SELECTION ----------
+
+int selectCPUDifficulty(void) {
+    int choice = 0;
+    while (choice < 1 || choice > 5) {
+        printf("\nChoose CPU difficulty:\n");
+        printf("1) Easy       (Simplistic Ai)\n");
+        printf("2) Normal     (SmartAI, looks 2 moves ahead)\n");
+        printf("3) Hard       (SmartAI, looks 3 moves ahead)\n");
+        printf("4) Almost Perfect    (SmartAI, looks 8 moves ahead, may be slow)\n");
+        printf("5) Perfect    (exact solver, slow in the opening)\n");
+
+        if (!readInt("Difficulty: ", &choice)) {
+            printf("Invalid input. Please enter 1, 2, 3, 4 or 5.\n");
+            continue;
+        }
+    }
+
+    static const int depths[] = {1, 2, 3, 8, 0};
+    int depth = depths[choice - 1];
+
+    if (depth == 0) {
+        printf("CPU difficulty set to perfect play (solver).\n");
+    } else {
+        printf("CPU difficulty set to depth %d.\n", depth);
+    }
+    return depth;
+}
+//For self learning algorithm, train games
+int promptTrainingGames(void) {
+    int games = 0;
+    while (games <= 0) {
+        printf("\nHow many self-play training games? (e.g. 5000, 20000, 100000)\n");
+        if (!readInt("Games: ", &games)) {
+            printf("Invalid input. Please enter a positive number.\n");
+            continue;
+        }
+        if (games <= 0) {
+            printf("Please enter a positive number.\n");
+        }
+        if (games > 5000000) {
+            printf("That is very large. Capping to 5,000,000.\n");
+            games = 5000000;
+        }
+    }
+    return games;
+}
+
+//Shows the winning combination in Green
+static void computeWinMask(char board[ROWS][COLS],
+                           char piece,
+                           int last_row, int last_col,
+                           int winMask[ROWS][COLS]) {
+    const WindowTable *wt = windowTable();
+
+    // Clear mask
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            winMask[r][c] = 0;
+        }
+    }
+
+    // Only windows through the last move can have completed a four
+    for (int i = 0; i < wt->cellWindowCount[last_row][last_col]; i++) {
+        const Window *w = &wt->windows[wt->cellWindows[last_row][last_col][i]];
+
+        int count = 0;
+        while (count < 4 && board[w->row[count]][w->col[count]] == piece) count++;
+
+        if (count == 4) {
+            // Mark winning cells
+            for (int k = 0; k < 4; k++) {
+                winMask[w->row[k]][w->col[k]] = 1;
+            }
+            return; // only one winning line needed
+        }
+    }
+}
+
+void displayBoardWin(char board[ROWS][COLS], char winner,
+                     int last_row, int last_col) {
+    int winMask[ROWS][COLS];
+    computeWinMask(board, winner, last_row, last_col, winMask);
+
+    // Always ignore color mode and threat coloring here:
+    // only show winning four in green, others plain.
+
+    printf("\n  ");
+    for (int c = 0; c < COLS; c++) {
+        printf(" %d ", c + 1);
+    }
+    printf("\n");
+
+    for (int r = 0; r < ROWS; r++) {
+        printf(" |");
+        for (int c = 0; c < COLS; c++) {
+            char cell = board[r][c];
+            if (winMask[r][c]) {
+                // Winning four -> green
+                printf(" %s%c%s ", CLR_WIN, cell, CLR_RESET);
+            } else {
+                // Everything else plain, no other colors
+                printf(" %c ", cell);
+            }
+        }
+        printf("|\n");
+    }
+
+    printf("  ");
+    for (int c = 0; c < COLS; c++) {
+        printf("---");
+    }
+    printf("-\n\n");
+}
+
+//For color mode, checking combinations of 3 and shows them with color
+static void computeThreatMasks(char board[ROWS][COLS],
+                               int threatP1[ROWS][COLS],
+                               int threatP2[ROWS][COLS]) {
+    const WindowTable *wt = windowTable();
+
+    // Clear masks
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) {
+            threatP1[r][c] = 0;
+            threatP2[r][c] = 0;
+        }
+    }
+
+    // Scan all windows of length 4
+    for (int n = 0; n < NUM_WINDOWS; n++) {
+        const Window *w = &wt->windows[n];
+        int p1 = 0, p2 = 0, empty = 0;
+        for (int i = 0; i < 4; i++) {
+            char cell = board[w->row[i]][w->col[i]];
+            if (cell == PLAYER1) p1++;
+            else if (cell == PLAYER2) p2++;
+            else empty++;
+        }
+
+        // Threat = 3 in a row + 1 empty, with no opponent pieces
+        int (*mask)[COLS] = NULL;
+        if (p1 == 3 && p2 == 0 && empty == 1) {
+            mask = threatP1;
+        } else if (p2 == 3 && p1 == 0 && empty == 1) {
+            mask = threatP2;
+        }
+        if (mask) {
+            for (int i = 0; i < 4; i++) {
+                mask[w->row[i]][w->col[i]] = 1;
+            }
+        }
+    }
+}
+
+
+
+// ---------- BOARD DISPLAY ----------
+
+void displayBoard(char board[ROWS][COLS], int color) {
+    // If color mode is off, use simple old-style display
+    if (!color) {
+        printf("\n  ");
+        for (int c = 0; c < COLS; c++) {
+            printf(" %d ", c + 1);
+        }
+        printf("\n");
+
+        for (int r = 0; r < ROWS; r++) {
+            printf(" |");
+            for (int c = 0; c < COLS; c++) {
+                printf(" %c ", board[r][c]);
+            }
+            printf("|\n");
+        }
+
+        printf("  ");
+        for (int c = 0; c < COLS; c++) {
+            printf("---");
+        }
+        printf("-\n\n");
+        return;
+    }
+
+    // Color mode: compute threat masks
+    int threatP1[ROWS][COLS];
+    int threatP2[ROWS][COLS];
+    computeThreatMasks(board, threatP1, threatP2);
+
+    printf("\n  ");
+    for (int c = 0; c < COLS; c++) {
+        printf(" %d ", c + 1);
+    }
+    printf("\n");
+
+    for (int r = 0; r < ROWS; r++) {
+        printf(" |");
+        for (int c = 0; c < COLS; c++) {
+            char cell = board[r][c];
+            const char *color = CLR_RESET;
+
+            if (cell == PLAYER1 && threatP1[r][c]) {
+                color = CLR_P1;                 // red X in a threat line
+            } else if (cell == PLAYER2 && threatP2[r][c]) {
+                color = CLR_P2;                 // blue O in a threat line
+            } else if (cell == EMPTY && (threatP1[r][c] || threatP2[r][c])) {
+                color = CLR_THREAT_EMPTY;       // yellow '.' that would complete 4
+            } else {
+                color = CLR_RESET;
+            }
+
+            printf(" %s%c%s ", color, cell, CLR_RESET);
+        }
+        printf("|\n");
+    }
+
+    printf("  ");
+    for (int c = 0; c < COLS; c++) {
+        printf("---");
+    }
+    printf("-\n\n");
+}
+
+
+// ---------- HUMAN MOVE ----------
+
+int getHumanMove(char board[ROWS][COLS], char piece) {
+    int col_input;
+
+    while (1) {
+        char prompt[64];
+        snprintf(prompt, sizeof(prompt),
+                 "Player %c, choose a column (1-%d): ", piece, COLS);
+
+        if (!readInt(prompt, &col_input)) {
+            printf("Error: please enter a number.\n");
+            continue;
+        }
+
+        int col = col_input - 1;
+
+        if (!isMoveValid(board, col)) {
+            printf("Error: column %d is not valid or is full.\n", col_input);
+            continue;
+        }
+
+        return col;
+    }
+}
+
+
+// ---------- CPU SEARCH REPORT ----------
+
+void reportCPUSearchStats(const C4Engine *e) {
+    const SearchStats *st = &e->stats;
+    if (strcmp(st->source, "book") == 0) {
+        printf("Book: score %d (%s)\n", e->lastBookScore,
+               (e->lastBookScore > 0) ? "CPU wins" : (e->lastBookScore < 0) ? "CPU loses" : "draw");
+        return;
+    }
+
+    if (strcmp(st->engine, "solver") == 0) {
+        const SolveResult *solve = &e->lastSolve;
+        const char *outcome = (solve->score > 0) ? "CPU wins" :
+                              (solve->score < 0) ? "CPU loses" : "draw";
+        printf("Solver: score %d (%s, game ends in %d plies), %llu nodes, %.1f ms\n",
+               solve->score, outcome, solve->pliesToEnd,
+               (unsigned long long)solve->nodes, solve->ms);
+        return;
+    }
+
+    searchStatsPrint(st, stdout);
+
+    if (!e->tt.entries) return;
+    printf("TT: %zu KB, %llu probes, %.1f%% hits, %.1f%% full\n",
+           ttSizeBytes(&e->tt) / 1024,
+           (unsigned long long)e->tt.probes,
+           100.0 * ttHitRate(&e->tt),
+           100.0 * ttFillRate(&e->tt));
+}
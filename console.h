@@ -0,0 +1,23 @@
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "connect_four.h"
+#include "engine.h"
+
+// -------- Interactive console (console.c) --------
+void displayBoard(char board[ROWS][COLS], int color);
+void displayBoardWin(char board[ROWS][COLS], char winner, int last_row, int last_col);
+int  getHumanMove(char board[ROWS][COLS], char piece);
+int  selectGameMode(void);
+
+// Returns 1 if threats should be shown in color
+int  selectColorMode(void);
+int  promptTrainingGames(void);
+
+// lets the user choose CPU difficulty: minimax depth, or 0 for the solver
+int  selectCPUDifficulty(void);
+
+// Prints depth, nodes, time and TT hit rate of the engine's last move
+void reportCPUSearchStats(const C4Engine *e);
+
+#endif
@@ -0,0 +1,785 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "engine.h"
+#include "bitboard.h"
+#include "timeutil.h"
+#include "windows.h"
+#include "book.h"
+
+// ---------- Engine context ----------
+
+void initCPUEngine(C4Engine *e) {
+    memset(e, 0, sizeof(*e));
+    e->depth = 2;   // "Normal"
+    e->threads = 1;
+    e->hashMB = CPU_HASH_MB_DEFAULT;
+    seedCPUEngine(e, 1);
+    searchStatsReset(&e->stats, "minimax", 0);
+}
+
+void freeCPUEngine(C4Engine *e) {
+    ttFree(&e->tt);
+    if (e->solverReady) solverFree(&e->solver);
+    e->solverReady = 0;
+}
+
+void setCPUDepth(C4Engine *e, int depth) {
+    e->useSolver = (depth <= 0);
+    if (depth > 0) e->depth = depth;
+}
+
+// Set transposition table memory in megabytes; 0 disables the table.
+int setCPUHashSize(C4Engine *e, int megabytes) {
+    if (megabytes < 0) return 0;
+    ttFree(&e->tt);
+    e->hashMB = (size_t)megabytes;
+    if (e->hashMB == 0) return 1;
+    return ttInit(&e->tt, e->hashMB);
+}
+
+void clearCPUHash(C4Engine *e) {
+    ttClear(&e->tt);
+}
+
+// With a time or node budget getCPUMove deepens iteratively up to the
+// difficulty depth and plays the best move of the deepest finished
+// iteration. Both 0 restores plain fixed-depth search.
+void setCPUSearchBudget(C4Engine *e, int moveTimeMs, long long nodeLimit) {
+    e->moveTimeMs = (moveTimeMs > 0) ? moveTimeMs : 0;
+    e->nodeLimit = (nodeLimit > 0) ? nodeLimit : 0;
+}
+
+int setCPUThreads(C4Engine *e, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > CPU_MAX_THREADS) threads = CPU_MAX_THREADS;
+    e->threads = threads;
+    return e->threads;
+}
+
+void setCPUBook(C4Engine *e, const Book *book) {
+    e->book = book;
+}
+
+void setCPUStopFlag(C4Engine *e, const atomic_int *stop) {
+    e->stop = stop;
+}
+
+void setCPUIterationCallback(C4Engine *e, CPUIterationFn fn, void *arg) {
+    e->onIteration = fn;
+    e->onIterationArg = arg;
+}
+
+void seedCPUEngine(C4Engine *e, uint64_t seed) {
+    rl_rng_seed(&e->rng, seed);
+}
+
+void getCPUSearchStats(const C4Engine *e, long long *nodes, double *ms) {
+    *nodes = e->stats.nodes;
+    *ms = e->stats.ms;
+}
+
+
+// =======================================================
+// SMART CPU (Minimax + Alpha-Beta)
+// =======================================================
+
+#define INF 1000000
+
+// Center-first move order for better alpha-beta pruning
+static const int columnOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+// ---------- Gravity + double-threat aware evaluation ----------
+
+// Score one 4-cell window from its stone counts; `playable` says whether
+// any of its empty cells can be played immediately.
+static int scoreWindow(int cpuCount, int humanCount, int playable) {
+    int emptyCount = 4 - cpuCount - humanCount;
+    int score = 0;
+
+    // Good patterns for CPU
+    if (cpuCount == 4) {
+        score += 100000;   // already winning pattern
+    } else if (cpuCount == 3 && emptyCount == 1) {
+        // Stronger if the empty spot is actually playable
+        if (playable) score += 180;
+        else          score += 60;
+    } else if (cpuCount == 2 && emptyCount == 2) {
+        score += 10;
+    }
+
+    // Good patterns for human (bad for CPU)
+    if (humanCount == 3 && emptyCount == 1) {
+        if (playable) score -= 220;  // urgent to block
+        else          score -= 80;
+    } else if (humanCount == 2 && emptyCount == 2) {
+        score -= 10;
+    }
+
+    return score;
+}
+
+// Scores are from the CPU's point of view, so the key also encodes
+// whose turn it is and which piece the CPU plays. Easy scores with a
+// different evaluation, so its entries get keys of their own and one
+// table can serve every difficulty.
+static uint64_t cpuHashKey(const Bitboard *bb, int cpuToMove, int cpuIdx, int easy) {
+    uint64_t key = bbKey(bb);
+    if (cpuToMove) key ^= 0xA3B195354A39B70DULL;
+    if (cpuIdx)    key ^= 0x1B56C4E9F2D3A817ULL;
+    if (easy)      key ^= 0x6C8E9CF570932BD5ULL;
+    return key;
+}
+
+// Per-search state, one per search thread.
+typedef struct {
+    TTable  *tt;              // the engine's table, shared by its threads
+    int      easy;            // depth 1 difficulty: plain window evaluation
+    const WindowTable *wt;
+    Bitboard bb;
+    char     cpu;
+    char     human;
+    int      order[COLS];     // child move order (helpers use a perturbed one)
+
+    // Budget: 0 means unlimited
+    long long nodeLimit;
+    double    deadline;       // timeNow() value
+    atomic_int *stopAll;      // set by the main thread to end helper threads
+    const atomic_int *abort;  // the engine's stop flag (NULL = none)
+
+    // Incremental evaluation, updated by makeMove / unmakeMove
+    uint8_t  windowCount[2][NUM_WINDOWS];  // stones per window, by player index
+    int      windowScore[NUM_WINDOWS];     // current scoreWindow() of each window
+    int      evalScore;                    // sum of windowScore + center bonus
+
+    // Move ordering learned during the search
+    int      rootMoves;                    // stones on the board at the root
+    int8_t   killers[ROWS * COLS][2];      // last two cutoff moves per ply, -1 = none
+    int      history[2][COLS * BB_HEIGHT]; // cutoff credit by player and landing cell
+
+    long long nodes;
+    long long leafEvals;
+    long long cutoffs;
+    long long firstCutoffs;   // cutoffs by the first move tried
+    long long ttProbes;
+    long long ttHits;
+    int       stopped;        // budget ran out, results of this iteration are void
+} SearchState;
+
+// Count a node and check the budget. Node limits are checked exactly so
+// single-threaded results stay reproducible; the clock is only read every
+// 1024 nodes.
+static int outOfBudget(SearchState *s) {
+    s->nodes++;
+    if (s->nodeLimit > 0 && s->nodes >= s->nodeLimit) s->stopped = 1;
+    if ((s->nodes & 1023) == 0) {
+        if (s->deadline > 0.0 && timeNow() >= s->deadline) s->stopped = 1;
+        if (s->stopAll && atomic_load_explicit(s->stopAll, memory_order_relaxed)) {
+            s->stopped = 1;
+        }
+        if (s->abort && atomic_load_explicit(s->abort, memory_order_relaxed)) {
+            s->stopped = 1;
+        }
+    }
+    return s->stopped;
+}
+
+// Recompute one window's score and fold the change into the running total.
+static void rescoreWindow(SearchState *s, int w, uint64_t playable) {
+    int cpuIdx = bbIndex(s->cpu);
+    int score = scoreWindow(s->windowCount[cpuIdx][w],
+                            s->windowCount[cpuIdx ^ 1][w],
+                            (playable & s->wt->windows[w].mask) != 0);
+    s->evalScore += score - s->windowScore[w];
+    s->windowScore[w] = score;
+}
+
+// Full evaluation from scratch; done once per search at the root.
+static void initEvaluation(SearchState *s) {
+    s->wt = windowTable();
+    uint64_t playable = bbPlayableCells(&s->bb);
+
+    s->evalScore = 0;
+    for (int w = 0; w < NUM_WINDOWS; w++) {
+        uint64_t mask = s->wt->windows[w].mask;
+        s->windowCount[0][w] = (uint8_t)bbPopcount(s->bb.pieces[0] & mask);
+        s->windowCount[1][w] = (uint8_t)bbPopcount(s->bb.pieces[1] & mask);
+        s->windowScore[w] = 0;
+        rescoreWindow(s, w, playable);
+    }
+
+    // Center column bonus
+    int center = COLS / 2;
+    for (int r = 0; r < ROWS; r++) {
+        if (s->bb.pieces[bbIndex(s->cpu)] & bbCellBit(r, center)) s->evalScore += 6;
+    }
+}
+
+// A stone at (r,c) changes the counts of the windows through it, and moves
+// the playable cell of column c up to (r-1,c), which changes the
+// "playable" flag of the windows through that cell as well.
+static void updateWindowsAround(SearchState *s, int r, int c, int who, int delta) {
+    const WindowTable *wt = s->wt;
+    uint64_t playable = bbPlayableCells(&s->bb);
+
+    for (int i = 0; i < wt->cellWindowCount[r][c]; i++) {
+        int w = wt->cellWindows[r][c][i];
+        s->windowCount[who][w] = (uint8_t)(s->windowCount[who][w] + delta);
+        rescoreWindow(s, w, playable);
+    }
+    if (r > 0) {
+        for (int i = 0; i < wt->cellWindowCount[r - 1][c]; i++) {
+            rescoreWindow(s, wt->cellWindows[r - 1][c][i], playable);
+        }
+    }
+    if (c == COLS / 2 && who == bbIndex(s->cpu)) s->evalScore += 6 * delta;
+}
+
+static void makeMove(SearchState *s, int c, int who) {
+    int r = bbLandingRow(&s->bb, c);
+    bbPlay(&s->bb, c, who);
+    updateWindowsAround(s, r, c, who, 1);
+}
+
+static void unmakeMove(SearchState *s, int c, int who) {
+    bbUndo(&s->bb, c, who);
+    updateWindowsAround(s, bbLandingRow(&s->bb, c), c, who, -1);
+}
+
+// Leaf evaluation: the incrementally maintained window/center score plus
+// the immediate-win terms, which are cheap on the bitboard.
+static int evaluateBoard(const SearchState *s) {
+    int score = s->evalScore;
+
+    // For Easy difficulty,
+    // no immediate-win / double-threat lookahead.
+    if (s->easy) {
+        return score;
+    }
+
+    // Double-threat / immediate-win counting (for Normal+)
+    int cpuWinNext   = bbCountWinningMoves(&s->bb, bbIndex(s->cpu));
+    int humanWinNext = bbCountWinningMoves(&s->bb, bbIndex(s->human));
+
+    if (cpuWinNext >= 2) {
+        score += 20000 * cpuWinNext;
+    } else if (cpuWinNext == 1) {
+        score += 5000;
+    }
+
+    if (humanWinNext >= 2) {
+        score -= 25000 * humanWinNext;
+    } else if (humanWinNext == 1) {
+        score -= 6000;
+    }
+
+    return score;
+}
+
+// ---------- Move ordering ----------
+
+#define ORDER_HASH     (1 << 30)
+#define ORDER_WIN      (1 << 29)
+#define ORDER_BLOCK    (1 << 28)
+#define ORDER_THREAT   (1 << 20)   // per new threat
+#define ORDER_KILLER   (1 << 19)
+#define HISTORY_MAX    (1 << 18)
+
+static void clearOrdering(SearchState *s) {
+    s->rootMoves = s->bb.moves;
+    memset(s->killers, -1, sizeof(s->killers));
+    memset(s->history, 0, sizeof(s->history));
+}
+
+// Order the playable columns for `who`: hash move, immediate wins, forced
+// blocks, moves creating new threats (only when `threats` is set, the count
+// is not free), then killers and history. `base` breaks ties.
+static int orderMoves(const SearchState *s, int who, int ttMove, int threats,
+                      const int base[COLS], int moves[COLS]) {
+    const Bitboard *bb = &s->bb;
+    uint64_t mask = bbOccupied(bb);
+    uint64_t own = bb->pieces[who];
+    uint64_t oppWins = bbWinningCells(bb->pieces[who ^ 1], mask);
+    int ownThreats = threats ? bbPopcount(bbWinningCells(own, mask)) : 0;
+    int ply = bb->moves - s->rootMoves;
+
+    int keys[COLS];
+    int n = 0;
+    for (int i = 0; i < COLS; i++) {
+        int c = base[i];
+        if (!bbCanPlay(bb, c)) continue;
+
+        int bit = c * BB_HEIGHT + bb->height[c];
+        uint64_t move = 1ULL << bit;
+        int key;
+        if (c == ttMove) {
+            key = ORDER_HASH;
+        } else if (bbIsWin(own | move)) {
+            key = ORDER_WIN;
+        } else if (oppWins & move) {
+            key = ORDER_BLOCK;
+        } else {
+            key = s->history[who][bit];
+            if (ply > 0 && (c == s->killers[ply][0] || c == s->killers[ply][1])) {
+                key += ORDER_KILLER;
+            }
+            if (threats) {
+                int created = bbPopcount(bbWinningCells(own | move, mask | move)) - ownThreats;
+                if (created > 0) key += ORDER_THREAT * created;
+            }
+        }
+
+        // Insertion sort, stable so equal keys keep the base order
+        int k = n++;
+        while (k > 0 && keys[k - 1] < key) {
+            moves[k] = moves[k - 1];
+            keys[k] = keys[k - 1];
+            k--;
+        }
+        moves[k] = c;
+        keys[k] = key;
+    }
+    return n;
+}
+
+// A beta cutoff by column c: remember it as a killer for this ply and
+// credit its landing cell in the history table.
+static void recordCutoff(SearchState *s, int who, int c, int depth) {
+    int ply = s->bb.moves - s->rootMoves;
+    if (s->killers[ply][0] != c) {
+        s->killers[ply][1] = s->killers[ply][0];
+        s->killers[ply][0] = (int8_t)c;
+    }
+
+    int *h = &s->history[who][c * BB_HEIGHT + s->bb.height[c]];
+    *h += depth * depth;
+    if (*h > HISTORY_MAX) {
+        // Age the whole table so recent cutoffs dominate
+        for (int i = 0; i < COLS * BB_HEIGHT; i++) s->history[who][i] /= 2;
+    }
+}
+
+static int minimax(SearchState *s, int depth, int alpha, int beta, int maximizingPlayer) {
+    Bitboard *bb = &s->bb;
+    int cpuIdx = bbIndex(s->cpu);
+    int humanIdx = bbIndex(s->human);
+
+    if (outOfBudget(s)) return 0;
+
+    // Terminal win/loss checks with depth-based bonuses
+    if (bbHasWon(bb, cpuIdx))   return  500000 + depth;
+    if (bbHasWon(bb, humanIdx)) return -500000 - depth;
+
+    if (depth == 0 || bbIsFull(bb)) {
+        s->leafEvals++;
+        return evaluateBoard(s);
+    }
+
+    uint64_t key = cpuHashKey(bb, maximizingPlayer, cpuIdx, s->easy);
+    TTData hit;
+    int ttMove = TT_NO_MOVE;
+    s->ttProbes++;
+    if (ttProbe(s->tt, key, &hit)) {
+        s->ttHits++;
+        ttMove = hit.move;
+        if (hit.depth >= depth) {
+            if (hit.bound == TT_EXACT) return hit.score;
+            if (hit.bound == TT_LOWER && hit.score > alpha) alpha = hit.score;
+            if (hit.bound == TT_UPPER && hit.score < beta)  beta = hit.score;
+            if (alpha >= beta) return hit.score;
+        }
+    }
+
+    int alphaOrig = alpha;
+    int betaOrig = beta;
+    int bestVal;
+    int bestMove = TT_NO_MOVE;
+
+    int moves[COLS];
+    int who = maximizingPlayer ? cpuIdx : humanIdx;
+    int n = orderMoves(s, who, ttMove, depth >= 2, s->order, moves);
+
+    if (maximizingPlayer) {
+        bestVal = -INF;
+
+        for (int i = 0; i < n; i++) {
+            int c = moves[i];
+
+            makeMove(s, c, cpuIdx);
+            int val = minimax(s, depth - 1, alpha, beta, 0);
+            unmakeMove(s, c, cpuIdx);
+            if (s->stopped) return 0;
+
+            if (val > bestVal) { bestVal = val; bestMove = c; }
+            if (val > alpha) alpha = val;
+            if (alpha >= beta) {  // alpha-beta prune
+                s->cutoffs++;
+                if (i == 0) s->firstCutoffs++;
+                recordCutoff(s, who, c, depth);
+                break;
+            }
+        }
+    } else {
+        bestVal = INF;
+
+        for (int i = 0; i < n; i++) {
+            int c = moves[i];
+
+            makeMove(s, c, humanIdx);
+            int val = minimax(s, depth - 1, alpha, beta, 1);
+            unmakeMove(s, c, humanIdx);
+            if (s->stopped) return 0;
+
+            if (val < bestVal) { bestVal = val; bestMove = c; }
+            if (val < beta) beta = val;
+            if (alpha >= beta) {  // alpha-beta prune
+                s->cutoffs++;
+                if (i == 0) s->firstCutoffs++;
+                recordCutoff(s, who, c, depth);
+                break;
+            }
+        }
+    }
+
+    int bound = TT_EXACT;
+    if (bestVal <= alphaOrig)     bound = TT_UPPER;
+    else if (bestVal >= betaOrig) bound = TT_LOWER;
+    ttStore(s->tt, key, bestVal, depth, bound, bestMove);
+
+    return bestVal;
+}
+
+
+// ---------- CPU MOVE ----------
+
+// Search every root column to `depth`. Fills bestCols with all columns
+// sharing the best score and returns how many there are (0 if the budget
+// ran out before the iteration finished). `rotate` shifts the root order
+// after the hash move so helper threads start on different columns.
+static int searchRoot(SearchState *s, int depth, int rotate,
+                      int bestCols[COLS], int *bestScoreOut) {
+    Bitboard *bb = &s->bb;
+    int cpuIdx = bbIndex(s->cpu);
+
+    // Root move order: last known best move for this position first, then
+    // the same dynamic ordering as inside the tree over a rotated
+    // center-first base order.
+    uint64_t rootKey = cpuHashKey(bb, 1, cpuIdx, s->easy);
+    TTData hit;
+    int ttMove = ttProbe(s->tt, rootKey, &hit) ? hit.move : TT_NO_MOVE;
+
+    int base[COLS];
+    for (int i = 0; i < COLS; i++) base[i] = columnOrder[(i + rotate) % COLS];
+    int order[COLS];
+    int n = orderMoves(s, cpuIdx, ttMove, 1, base, order);
+
+    int bestScore = -INF;
+    int bestCount = 0;
+
+    for (int i = 0; i < n; i++) {
+        int c = order[i];
+        // Only scores >= bestScore matter (ties are kept for variety),
+        // so later columns can be searched with a narrowed window.
+        int alpha = (bestScore == -INF) ? -INF : bestScore - 1;
+
+        makeMove(s, c, cpuIdx);
+        int score = minimax(s, depth - 1, alpha, INF, 0);
+        unmakeMove(s, c, cpuIdx);
+        if (s->stopped) return 0;
+
+        if (score > bestScore) {
+            bestScore = score;
+            bestCount = 0;
+            bestCols[bestCount++] = c;
+        } else if (score == bestScore) {
+            bestCols[bestCount++] = c;
+        }
+    }
+
+    if (bestCount > 0) {
+        ttStore(s->tt, rootKey, bestScore, depth, TT_EXACT, bestCols[0]);
+    }
+    *bestScoreOut = bestScore;
+    return bestCount;
+}
+
+// One iterative-deepening search; the main thread and every helper own one.
+typedef struct {
+    SearchState s;
+    int  index;            // 0 = main thread
+    int  startDepth;
+    int  maxDepth;
+
+    int  bestCols[COLS];
+    int  bestCount;
+    int  bestScore;
+    int  completedDepth;
+
+    // Progress reports, main thread only
+    CPUIterationFn onIteration;
+    void          *onIterationArg;
+    double         start;
+} SearchWorker;
+
+static int isDecisive(int score) {
+    return score >= 500000 || score <= -500000;
+}
+
+static void collectPV(const SearchState *s, int move, SearchStats *st);
+
+static void reportIteration(const SearchWorker *w) {
+    if (!w->onIteration || w->bestCount == 0) return;
+
+    const SearchState *s = &w->s;
+    SearchStats st;
+    searchStatsReset(&st, "minimax", s->bb.moves);
+    st.move = w->bestCols[0];
+    st.score = w->bestScore;
+    st.depth = w->completedDepth;
+    st.nodes = s->nodes;
+    st.leafEvals = s->leafEvals;
+    st.cutoffs = s->cutoffs;
+    st.firstCutoffs = s->firstCutoffs;
+    st.ttProbes = s->ttProbes;
+    st.ttHits = s->ttHits;
+    st.ms = (timeNow() - w->start) * 1000.0;
+    collectPV(s, st.move, &st);
+    w->onIteration(&st, w->onIterationArg);
+}
+
+static void iterativeDeepening(SearchWorker *w) {
+    for (int depth = w->startDepth; depth <= w->maxDepth; depth++) {
+        // A forced win or loss is already known; deeper search won't change it
+        if (w->completedDepth > 0 && isDecisive(w->bestScore)) break;
+
+        int cols[COLS];
+        int score;
+        int count = searchRoot(&w->s, depth, w->index, cols, &score);
+        if (w->s.stopped) break;
+
+        memcpy(w->bestCols, cols, sizeof(cols));
+        w->bestCount = count;
+        w->bestScore = score;
+        w->completedDepth = depth;
+        reportIteration(w);
+    }
+}
+
+static void *helperThreadMain(void *arg) {
+    iterativeDeepening((SearchWorker *)arg);
+    return NULL;
+}
+
+int evaluateCPUPosition(const C4Engine *e, char board[ROWS][COLS], char cpuPiece) {
+    SearchState s;
+    memset(&s, 0, sizeof(s));
+    s.easy = (e->depth == 1);
+    bbFromBoard(&s.bb, board);
+    s.cpu = cpuPiece;
+    s.human = (cpuPiece == PLAYER1) ? PLAYER2 : PLAYER1;
+    initEvaluation(&s);
+    return evaluateBoard(&s);
+}
+
+static int getSolverMove(C4Engine *e, char board[ROWS][COLS], char cpuPiece) {
+    if (!e->solverReady) {
+        if (!solverInit(&e->solver, SOLVER_HASH_MB_DEFAULT)) return -1;
+        e->solverReady = 1;
+    }
+    return solveBoard(&e->solver, board, cpuPiece, &e->lastSolve);
+}
+
+// Principal variation of the last search: `move`, then the hash moves
+// stored for the positions along the line, up to the search depth. An
+// overwritten entry ends it early.
+static void collectPV(const SearchState *s, int move, SearchStats *st) {
+    Bitboard bb = s->bb;
+    int cpuIdx = bbIndex(s->cpu);
+    int who = cpuIdx;
+    int c = move;
+
+    st->pvLength = 0;
+    while (st->pvLength < st->depth && c >= 0 && c < COLS && bbCanPlay(&bb, c)) {
+        bbPlay(&bb, c, who);
+        st->pv[st->pvLength++] = (signed char)c;
+        if (bbHasWon(&bb, who) || bbIsFull(&bb)) break;
+
+        who ^= 1;
+        TTData hit;
+        if (!ttProbe(s->tt, cpuHashKey(&bb, who == cpuIdx, cpuIdx, s->easy), &hit)) break;
+        c = hit.move;
+    }
+}
+
+int getCPUMove(C4Engine *e, char board[ROWS][COLS], char cpuPiece) {
+    SearchStats *st = &e->stats;
+    int stones = 0;
+    for (int r = 0; r < ROWS; r++) {
+        for (int c = 0; c < COLS; c++) stones += (board[r][c] != EMPTY);
+    }
+    searchStatsReset(st, e->useSolver ? "solver" : "minimax", stones);
+    e->lastStopped = 0;
+
+    // Easy (depth 1) stays easy in the opening: no perfect book moves
+    if (e->book && (e->useSolver || e->depth > 1)) {
+        Bitboard bb;
+        bbFromBoard(&bb, board);
+        int move = bookBestMove(e->book, &bb, bbIndex(cpuPiece), &e->lastBookScore);
+        if (move >= 0) {
+            st->source = "book";
+            st->move = move;
+            st->score = e->lastBookScore;
+            st->pv[0] = (signed char)move;
+            st->pvLength = 1;
+            return move;
+        }
+    }
+
+    if (e->useSolver) {
+        int move = getSolverMove(e, board, cpuPiece);
+        if (move >= 0) {
+            st->move = move;
+            st->score = e->lastSolve.score;
+            st->depth = e->lastSolve.pliesToEnd;
+            st->nodes = (long long)e->lastSolve.nodes;
+            st->ms = e->lastSolve.ms;
+            st->pv[0] = (signed char)move;
+            st->pvLength = 1;
+            return move;
+        }
+        // Out of memory for the solver table: fall back to minimax
+        e->useSolver = 0;
+        st->engine = "minimax";
+    }
+
+    if (!e->tt.entries && e->hashMB > 0) ttInit(&e->tt, e->hashMB);
+
+    SearchWorker workers[CPU_MAX_THREADS];
+    SearchWorker *lead = &workers[0];
+    SearchState *s = &lead->s;
+    atomic_int stopAll;
+    atomic_init(&stopAll, 0);
+
+    memset(lead, 0, sizeof(*lead));
+    s->tt = &e->tt;
+    s->easy = (e->depth == 1);
+    bbFromBoard(&s->bb, board);
+    s->cpu = cpuPiece;
+    s->human = (cpuPiece == PLAYER1) ? PLAYER2 : PLAYER1;
+    initEvaluation(s);
+    clearOrdering(s);
+    memcpy(s->order, columnOrder, sizeof(s->order));
+    s->stopAll = &stopAll;
+
+    double start = timeNow();
+    // A stoppable search deepens iteratively too, so a stop always leaves
+    // a finished iteration to play
+    int budgeted = (e->moveTimeMs > 0 || e->nodeLimit > 0 || e->onIteration || e->stop);
+    int threads = e->threads;
+    int started = 0;
+
+    int maxDepth = e->depth;
+    int empty = ROWS * COLS - s->bb.moves;
+    if (maxDepth > empty) maxDepth = empty;
+    lead->maxDepth = maxDepth;
+
+    if (!budgeted && threads <= 1) {
+        // Fixed depth from the difficulty setting
+        lead->bestCount = searchRoot(s, maxDepth, 0, lead->bestCols, &lead->bestScore);
+        lead->completedDepth = maxDepth;
+    } else {
+        // Iterative deepening: keep the result of the deepest iteration
+        // that finished inside the budget. Depth 1 runs before the budget
+        // is armed so there is always a move to play.
+        lead->bestCount = searchRoot(s, 1, 0, lead->bestCols, &lead->bestScore);
+        lead->completedDepth = 1;
+        lead->startDepth = 2;
+        lead->start = start;
+        lead->onIteration = e->onIteration;
+        lead->onIterationArg = e->onIterationArg;
+        reportIteration(lead);
+
+        s->nodeLimit = e->nodeLimit;
+        if (e->moveTimeMs > 0) s->deadline = start + e->moveTimeMs / 1000.0;
+        s->abort = e->stop;
+
+        // Lazy SMP: helpers run the same iterative deepening on the same
+        // root, sharing only the transposition table. Odd helpers start one
+        // ply deeper and all of them use a different root rotation and child
+        // order, so they fill the table with lines the main thread needs
+        // next instead of duplicating its work.
+        pthread_t tids[CPU_MAX_THREADS];
+        for (int t = 1; t < threads && !isDecisive(lead->bestScore); t++) {
+            SearchWorker *w = &workers[t];
+            *w = *lead;
+            w->index = t;
+            w->onIteration = NULL;
+            w->startDepth = 2 + (t & 1);
+            w->s.nodeLimit = 0;
+            // Counters start at zero; depth 1 is already in the lead's
+            w->s.nodes = w->s.leafEvals = w->s.cutoffs = w->s.firstCutoffs = 0;
+            w->s.ttProbes = w->s.ttHits = 0;
+            if (t & 1) {
+                // swap neighbours in the center-first order: {3,4,2,5,1,6,0}
+                static const int alt[COLS] = {3, 4, 2, 5, 1, 6, 0};
+                memcpy(w->s.order, alt, sizeof(alt));
+            }
+            if (pthread_create(&tids[started], NULL, helperThreadMain, w) != 0) break;
+            started++;
+        }
+
+        iterativeDeepening(lead);
+
+        atomic_store(&stopAll, 1);
+        for (int t = 0; t < started; t++) {
+            pthread_join(tids[t], NULL);
+        }
+
+        // A helper may have finished a deeper iteration than the main thread
+        // before the budget ran out.
+        SearchWorker *best = lead;
+        for (int t = 1; t <= started; t++) {
+            if (workers[t].completedDepth > best->completedDepth) best = &workers[t];
+        }
+        if (best != lead) {
+            memcpy(lead->bestCols, best->bestCols, sizeof(lead->bestCols));
+            lead->bestCount = best->bestCount;
+            lead->bestScore = best->bestScore;
+            lead->completedDepth = best->completedDepth;
+        }
+
+    }
+
+    // Counters summed over the main thread and the helpers
+    for (int t = 0; t <= started; t++) {
+        const SearchState *ws = &workers[t].s;
+        st->nodes += ws->nodes;
+        st->leafEvals += ws->leafEvals;
+        st->cutoffs += ws->cutoffs;
+        st->firstCutoffs += ws->firstCutoffs;
+        st->ttProbes += ws->ttProbes;
+        st->ttHits += ws->ttHits;
+        ttAddStats(&e->tt, (uint64_t)ws->ttProbes, (uint64_t)ws->ttHits);
+    }
+    st->threads = started + 1;
+    e->lastStopped = s->stopped && e->stop && atomic_load(e->stop);
+    st->depth = lead->completedDepth;
+    st->score = lead->bestScore;
+    st->ms = (timeNow() - start) * 1000.0;
+
+    int move = -1;
+    if (lead->bestCount > 0) {
+        move = lead->bestCols[rl_rng_next(&e->rng) % (uint32_t)lead->bestCount];
+    } else {
+        // Fallback: just pick the first valid move in natural order
+        for (int c = 0; c < COLS && move < 0; c++) {
+            if (isMoveValid(board, c)) move = c;
+        }
+        if (move < 0) move = 0;
+    }
+    st->move = move;
+    collectPV(s, move, st);
+    return move;
+}
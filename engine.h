@@ -0,0 +1,110 @@
+#ifndef ENGINE_H
+#define ENGINE_H
+
+#include <stddef.h>
+#include <stdatomic.h>
+#include "connect_four.h"
+#include "ttable.h"
+#include "solver.h"
+#include "rl_agent.h"
+#include "searchstats.h"
+
+// =======================================================
+// CPU engine context (libc4)
+// =======================================================
+//
+// Everything one player's searches need: settings, transposition table,
+// solver table, random generator and the statistics of the last move.
+// The library keeps no other mutable state, so separate contexts can
+// search concurrently on different threads; a single context is used by
+// one thread at a time.
+//
+// The minimax CPU (getCPUMove) uses every field; the self-learning AI
+// (rl_choose_move) uses depth, moveTimeMs, book, rng and stats.
+
+#define CPU_HASH_MB_DEFAULT 16
+#define CPU_MAX_THREADS 64
+
+struct Book;
+
+// Called after every finished iteration of an iterative-deepening search
+// with the depth, score, nodes, time and PV so far, on the searching
+// thread. Node counts are the main search thread's.
+typedef void (*CPUIterationFn)(const SearchStats *st, void *arg);
+
+typedef struct C4Engine {
+    // Settings, changed through the setters below
+    int         depth;          // search depth (minimax: difficulty)
+    int         useSolver;      // "Perfect" difficulty: exact solver move
+    int         moveTimeMs;     // per-move budget, 0 = none
+    long long   nodeLimit;      // minimax node budget, 0 = none
+    int         threads;        // minimax Lazy-SMP threads
+    const struct Book *book;    // probed before searching, not at Easy (NULL = none)
+    const atomic_int *stop;     // set by another thread to end a search (NULL = none)
+    CPUIterationFn onIteration; // progress reports (NULL = none)
+    void       *onIterationArg;
+
+    // Tables, allocated on first use
+    TTable      tt;
+    size_t      hashMB;
+    Solver      solver;
+    int         solverReady;
+
+    RLRng       rng;            // tie-breaks and exploration
+
+    // Results of the last move
+    SearchStats stats;
+    SolveResult lastSolve;      // solver moves
+    int         lastBookScore;  // book moves
+    int         lastStopped;    // the last search was ended by *stop
+} C4Engine;
+
+// Depth 2 ("Normal"), 16 MB hash, one thread, no budget, seed 1.
+void initCPUEngine(C4Engine *e);
+void freeCPUEngine(C4Engine *e);
+
+// Difficulty: minimax depth, or 0 for the exact solver
+void setCPUDepth(C4Engine *e, int depth);
+
+// Transposition table size in MB (0 disables it). Returns 0 if the
+// table cannot be allocated.
+int  setCPUHashSize(C4Engine *e, int megabytes);
+
+// Forget every stored search result (e.g. between unrelated games)
+void clearCPUHash(C4Engine *e);
+
+// Optional per-move budget (ms / nodes, 0 = none) for iterative deepening
+void setCPUSearchBudget(C4Engine *e, int moveTimeMs, long long nodeLimit);
+
+// Lazy-SMP search threads for getCPUMove (1 = single-threaded)
+int  setCPUThreads(C4Engine *e, int threads);
+
+// Opening book probed before searching (NULL = none). The minimax CPU
+// at depth 1 (Easy) never plays book moves.
+void setCPUBook(C4Engine *e, const struct Book *book);
+
+// Let another thread end getCPUMove early by setting *stop (NULL = none).
+// With a stop flag the minimax CPU always deepens iteratively: a stopped
+// search plays the best move of its deepest finished iteration (at least
+// depth 1), reports that depth and sets lastStopped. The solver cannot be
+// stopped.
+void setCPUStopFlag(C4Engine *e, const atomic_int *stop);
+
+// Report every finished iteration of getCPUMove to `fn` (NULL = none).
+// With a callback the minimax CPU always deepens iteratively.
+void setCPUIterationCallback(C4Engine *e, CPUIterationFn fn, void *arg);
+
+// Restart the random generator (reproducible tie-breaks)
+void seedCPUEngine(C4Engine *e, uint64_t seed);
+
+// Best column for `cpuPiece`; statistics go to e->stats
+int  getCPUMove(C4Engine *e, char board[ROWS][COLS], char cpuPiece);
+
+// Nodes and milliseconds of the last getCPUMove call (0 for a book move)
+void getCPUSearchStats(const C4Engine *e, long long *nodes, double *ms);
+
+// The minimax leaf evaluation of a position for `cpuPiece`, computed from
+// scratch (the search itself updates it incrementally)
+int  evaluateCPUPosition(const C4Engine *e, char board[ROWS][COLS], char cpuPiece);
+
+#endif
@@ -0,0 +1,200 @@
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include "gamelog.h"
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#define GAMELOG_HEADER_SIZE 8
+
+size_t gameLogPack(const GameRecord *rec, uint8_t *out) {
+    size_t n = 2 + ((size_t)rec->moves + 1) / 2;
+    memset(out, 0, n);
+    out[0] = (uint8_t)rec->moves;
+    out[1] = (uint8_t)((rec->first & 1) | (rec->result << 1));
+    for (int i = 0; i < rec->moves; i++) {
+        out[2 + i / 2] |= (uint8_t)((rec->cols[i] & 0xf) << ((i & 1) * 4));
+    }
+    return n;
+}
+
+// ---------- Writing ----------
+
+// Bytes of a record with `moves` stones, 0 if no valid record has that many
+static size_t recordSize(size_t moves) {
+    if (moves == 0 || moves > ROWS * COLS) return 0;
+    return 2 + (moves + 1) / 2;
+}
+
+// File length up to the end of the last complete record, reading from
+// just behind the header. A crash mid-append can leave a partial record.
+static long completeLength(FILE *fp) {
+    uint8_t rec[GAMELOG_MAX_RECORD];
+    long end = GAMELOG_HEADER_SIZE;
+    while (fread(rec, 1, 2, fp) == 2) {
+        size_t len = recordSize(rec[0]);
+        if (len == 0 || fread(rec + 2, 1, len - 2, fp) != len - 2) break;
+        end += (long)len;
+    }
+    return end;
+}
+
+int gameLogWriterOpen(GameLogWriter *w, const char *path) {
+    memset(w, 0, sizeof(*w));
+
+    // An existing file must already be a game log; appending resumes
+    // behind its last complete record
+    FILE *fp = fopen(path, "r+b");
+    if (!fp) {
+        if (errno != ENOENT) return 0;
+        fp = fopen(path, "wb");
+        if (!fp) return 0;
+    }
+
+    char magic[4];
+    uint32_t ver = 0;
+    size_t got = fread(magic, 1, 4, fp);
+    int ok;
+    if (got == 0) {
+        // New or empty file
+        ver = GAMELOG_VERSION;
+        ok = fseek(fp, 0, SEEK_SET) == 0 &&
+             fwrite(GAMELOG_MAGIC, 1, 4, fp) == 4 &&
+             fwrite(&ver, sizeof(ver), 1, fp) == 1;
+    } else {
+        ok = got == 4 && memcmp(magic, GAMELOG_MAGIC, 4) == 0 &&
+             fread(&ver, sizeof(ver), 1, fp) == 1 && ver == GAMELOG_VERSION;
+        if (ok) {
+            long end = completeLength(fp);
+            ok = fseek(fp, end, SEEK_SET) == 0;
+#ifdef _WIN32
+            if (ok) ok = (_chsize_s(_fileno(fp), end) == 0);
+#else
+            if (ok) ok = (ftruncate(fileno(fp), (off_t)end) == 0);
+#endif
+        }
+    }
+    if (!ok) {
+        fclose(fp);
+        return 0;
+    }
+    w->fp = fp;
+    return 1;
+}
+
+int gameLogWrite(GameLogWriter *w, const uint8_t *data, size_t size, int games) {
+    if (w->failed || !w->fp) return 0;
+    if (fwrite(data, 1, size, w->fp) != size) {
+        w->failed = 1;
+        return 0;
+    }
+    w->games += (uint64_t)games;
+    return 1;
+}
+
+int gameLogWriterClose(GameLogWriter *w) {
+    int ok = !w->failed;
+    if (w->fp && fclose(w->fp) != 0) ok = 0;
+    w->fp = NULL;
+    return ok;
+}
+
+// ---------- Reading ----------
+
+#ifndef _WIN32
+// Count the complete records of a mapped log, storing their offsets
+// unless `offsets` is NULL
+static uint64_t indexRecords(const uint8_t *data, size_t bytes, uint64_t *offsets) {
+    uint64_t count = 0;
+    size_t pos = 0;
+    while (pos + 2 <= bytes) {
+        // A record that cannot be valid ends the log like a truncated one
+        size_t len = recordSize(data[pos]);
+        if (len == 0 || pos + len > bytes) break;
+        if (offsets) offsets[count] = pos;
+        count++;
+        pos += len;
+    }
+    return count;
+}
+#endif
+
+int gameLogOpen(GameLog *log, const char *path) {
+    memset(log, 0, sizeof(*log));
+#ifdef _WIN32
+    (void)path;
+    return 0;   // no mmap on Windows builds
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < GAMELOG_HEADER_SIZE) {
+        close(fd);
+        return 0;
+    }
+
+    size_t size = (size_t)st.st_size;
+    void *map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);   // the mapping stays valid
+    if (map == MAP_FAILED) return 0;
+
+    uint32_t ver;
+    memcpy(&ver, (const char *)map + 4, sizeof(ver));
+    if (memcmp(map, GAMELOG_MAGIC, 4) != 0 || ver != GAMELOG_VERSION) {
+        munmap(map, size);
+        return 0;
+    }
+
+    const uint8_t *data = (const uint8_t *)map + GAMELOG_HEADER_SIZE;
+    size_t bytes = size - GAMELOG_HEADER_SIZE;
+
+    // Count the records first so the index takes exactly 8 bytes per game
+    uint64_t count = indexRecords(data, bytes, NULL);
+    uint64_t *offsets = malloc(sizeof(uint64_t) * (count ? count : 1));
+    if (!offsets) {
+        munmap(map, size);
+        return 0;
+    }
+    indexRecords(data, bytes, offsets);
+
+    log->map = map;
+    log->mapSize = size;
+    log->data = data;
+    log->count = count;
+    log->offsets = offsets;
+    return 1;
+#endif
+}
+
+void gameLogClose(GameLog *log) {
+    free(log->offsets);
+#ifndef _WIN32
+    if (log->map) munmap(log->map, log->mapSize);
+#endif
+    memset(log, 0, sizeof(*log));
+}
+
+int gameLogRead(const GameLog *log, uint64_t i, GameRecord *rec) {
+    if (i >= log->count) return 0;
+    const uint8_t *p = log->data + log->offsets[i];
+
+    rec->moves = p[0];
+    rec->first = p[1] & 1;
+    rec->result = (p[1] >> 1) & 3;
+    if (rec->moves < 1 || rec->moves > ROWS * COLS || rec->result > GAMELOG_O_WON) return 0;
+
+    for (int k = 0; k < rec->moves; k++) {
+        int c = (p[2 + k / 2] >> ((k & 1) * 4)) & 0xf;
+        if (c >= COLS) return 0;
+        rec->cols[k] = (int8_t)c;
+    }
+    return 1;
+}
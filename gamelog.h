@@ -0,0 +1,84 @@
+#ifndef GAMELOG_H
+#define GAMELOG_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "connect_four.h"
+
+// =======================================================
+// Self-play experience log
+// =======================================================
+//
+// File layout:
+//   char     magic[4]    "C4GL"
+//   uint32_t version     (1)
+//   then one record per game, back to back:
+//   uint8_t  moves       stones played (1..42)
+//   uint8_t  info        bit 0: player index (0 = X) that moved first
+//                        bits 1-2: result (GAMELOG_DRAW / _X_WON / _O_WON)
+//   uint8_t  cols[(moves + 1) / 2]   one column per nibble, low nibble first
+//
+// Self-play appends whole records, so a log can grow across runs; a
+// record cut short by a crash is dropped before the next append. The
+// offline trainer mmaps the file and indexes the records once at open.
+
+#define GAMELOG_MAGIC   "C4GL"
+#define GAMELOG_VERSION 1
+
+#define GAMELOG_DRAW  0
+#define GAMELOG_X_WON 1
+#define GAMELOG_O_WON 2
+
+// Largest record: 2 header bytes + 42 nibbles
+#define GAMELOG_MAX_RECORD (2 + (ROWS * COLS + 1) / 2)
+
+typedef struct {
+    int    first;               // player index that moved first
+    int    result;              // GAMELOG_*
+    int    moves;
+    int8_t cols[ROWS * COLS];
+} GameRecord;
+
+// Pack one game into `out` (GAMELOG_MAX_RECORD bytes); returns its size.
+size_t gameLogPack(const GameRecord *rec, uint8_t *out);
+
+// ---------- Writing ----------
+
+typedef struct GameLogWriter {
+    FILE    *fp;
+    uint64_t games;     // records written by this writer
+    int      failed;    // a write failed; later writes are dropped
+} GameLogWriter;
+
+// Open `path` for appending, writing the header if the file is new. A
+// partial record left at the end by a crash is cut off first.
+// Returns 0 if it cannot be opened or is not a game log.
+int  gameLogWriterOpen(GameLogWriter *w, const char *path);
+
+// Append packed records (from gameLogPack). Returns 0 on a write error.
+int  gameLogWrite(GameLogWriter *w, const uint8_t *data, size_t size, int games);
+
+// Flush and close. Returns 0 if any write failed.
+int  gameLogWriterClose(GameLogWriter *w);
+
+// ---------- Reading ----------
+
+typedef struct GameLog {
+    const uint8_t *data;      // first record
+    uint64_t       count;     // complete records
+    uint64_t      *offsets;   // record start per game, relative to data
+
+    void          *map;       // whole file mapping
+    size_t         mapSize;
+} GameLog;
+
+// Map a log and index its records; a truncated last record is ignored.
+// Returns 1 on success, 0 if missing or invalid.
+int  gameLogOpen(GameLog *log, const char *path);
+void gameLogClose(GameLog *log);
+
+// Unpack game `i`. Returns 0 for a malformed record.
+int  gameLogRead(const GameLog *log, uint64_t i, GameRecord *rec);
+
+#endif
@@ -0,0 +1,389 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "connect_four.h"
+#include "rl_agent.h"
+#include "timeutil.h"
+
+// =======================================================
+// Load generator for c4_server (c4_load)
+// =======================================================
+//
+// Opens N client connections and keeps every one of them playing: each
+// client starts a game against the server's engine, answers every engine
+// move with a random legal move, and starts the next game when one ends,
+// alternating sides. One request per client is in flight at a time. The
+// report gives requests and engine moves per second and the reply latency
+// percentiles (time from sending a request to reading its reply line).
+
+#ifdef __linux__
+
+#define LOAD_LINE_MAX 256
+#define LOAD_EVENTS   256
+
+typedef struct {
+    int    fd;
+    char   in[LOAD_LINE_MAX];
+    size_t inLen;
+    char   board[ROWS][COLS];
+    char   piece;          // our stones
+    int    games;
+    double sentAt;         // 0 = nothing in flight
+    RLRng  rng;
+} Client;
+
+typedef struct {
+    const char *engine;
+    double     *latency;   // ms per reply
+    size_t      count;
+    size_t      cap;
+    long long   engineMoves;
+    long long   games;
+    long long   errors;
+    int         failed;    // connections lost
+} LoadStats;
+
+// ---------------- Requests ----------------
+
+static int sendLine(Client *c, const char *line) {
+    size_t len = strlen(line);
+    size_t sent = 0;
+    while (sent < len) {
+        ssize_t n = send(c->fd, line + sent, len - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            // A request is a few bytes and the server reads before it
+            // answers, so a full socket buffer means the server is gone
+            return 0;
+        } else {
+            return 0;
+        }
+    }
+    c->sentAt = timeNow();
+    return 1;
+}
+
+static int newGame(Client *c, const LoadStats *st) {
+    char line[LOAD_LINE_MAX];
+    initializeBoard(c->board);
+    c->piece = (c->games & 1) ? PLAYER2 : PLAYER1;
+    c->games++;
+    snprintf(line, sizeof(line), "new %s %s\n", st->engine,
+             (c->piece == PLAYER1) ? "first" : "second");
+    return sendLine(c, line);
+}
+
+static int randomMove(Client *c) {
+    char line[32];
+    int valid[COLS];
+    int n = 0;
+    for (int col = 0; col < COLS; col++) {
+        if (isMoveValid(c->board, col)) valid[n++] = col;
+    }
+    int col = valid[rl_rng_next(&c->rng) % (uint32_t)n];
+    dropPiece(c->board, col, c->piece);
+    snprintf(line, sizeof(line), "move %d\n", col + 1);
+    return sendLine(c, line);
+}
+
+static void recordLatency(LoadStats *st, double ms) {
+    if (st->count == st->cap) {
+        size_t cap = st->cap ? st->cap * 2 : 65536;
+        double *lat = realloc(st->latency, cap * sizeof(double));
+        if (!lat) return;
+        st->latency = lat;
+        st->cap = cap;
+    }
+    st->latency[st->count++] = ms;
+}
+
+// Act on one reply line; returns 0 if the client should stop.
+static int handleReply(Client *c, char *line, LoadStats *st, int sending) {
+    recordLatency(st, (timeNow() - c->sentAt) * 1000.0);
+    c->sentAt = 0.0;
+
+    int gameOver = 0;
+    if (strncmp(line, "reply ", 6) == 0) {
+        int col = atoi(line + 6) - 1;
+        char engine = (c->piece == PLAYER1) ? PLAYER2 : PLAYER1;
+        if (!isMoveValid(c->board, col)) {
+            st->errors++;
+            gameOver = 1;
+        } else {
+            dropPiece(c->board, col, engine);
+            st->engineMoves++;
+            gameOver = (strchr(line + 6, ' ') != NULL);   // result attached
+        }
+    } else if (strncmp(line, "end ", 4) == 0) {
+        gameOver = 1;
+    } else if (strcmp(line, "ok") != 0) {
+        st->errors++;
+        gameOver = 1;
+    }
+
+    if (!sending) return 0;
+    if (gameOver) {
+        st->games++;
+        return newGame(c, st);
+    }
+    return randomMove(c);
+}
+
+// ---------------- Connections ----------------
+
+static int connectClient(const char *unixPath, const char *host, int port) {
+    int fd;
+    if (unixPath) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(unixPath) >= sizeof(addr.sun_path)) return -1;
+        strcpy(addr.sun_path, unixPath);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        if (inet_pton(AF_INET, host, &addr.sin_addr) != 1) return -1;
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            return -1;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+static void dropClient(int epfd, Client *c, LoadStats *st) {
+    epoll_ctl(epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    st->failed++;
+}
+
+// Read what arrived and answer every complete line.
+static void onReadable(int epfd, Client *c, LoadStats *st, int sending) {
+    for (;;) {
+        ssize_t n = recv(c->fd, c->in + c->inLen, sizeof(c->in) - c->inLen, 0);
+        if (n > 0) {
+            c->inLen += (size_t)n;
+            if (c->inLen == sizeof(c->in)) break;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            dropClient(epfd, c, st);
+            return;
+        }
+    }
+
+    size_t start = 0;
+    for (;;) {
+        char *nl = memchr(c->in + start, '\n', c->inLen - start);
+        if (!nl) break;
+        *nl = '\0';
+        if (!handleReply(c, c->in + start, st, sending) && sending) {
+            dropClient(epfd, c, st);
+            return;
+        }
+        start = (size_t)(nl - c->in) + 1;
+    }
+    memmove(c->in, c->in + start, c->inLen - start);
+    c->inLen -= start;
+    if (c->inLen == sizeof(c->in)) dropClient(epfd, c, st);   // no newline
+}
+
+// ---------------- Report ----------------
+
+static int compareDouble(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentile(const double *sorted, size_t n, double p) {
+    if (n == 0) return 0.0;
+    return sorted[(size_t)(p * (double)(n - 1) + 0.5)];
+}
+
+static void printReport(LoadStats *st, int clients, double secs) {
+    qsort(st->latency, st->count, sizeof(double), compareDouble);
+    printf("%d clients, engine %s, %.1f s\n", clients, st->engine, secs);
+    printf("  %zu requests (%.0f/s), %lld engine moves (%.0f moves/s), %lld games\n",
+           st->count, st->count / secs, st->engineMoves, st->engineMoves / secs, st->games);
+    printf("  latency ms: p50 %.3f  p90 %.3f  p99 %.3f  max %.3f\n",
+           percentile(st->latency, st->count, 0.50),
+           percentile(st->latency, st->count, 0.90),
+           percentile(st->latency, st->count, 0.99),
+           st->count ? st->latency[st->count - 1] : 0.0);
+    if (st->errors || st->failed) {
+        printf("  %lld error replies, %d connections lost\n", st->errors, st->failed);
+    }
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --port N          Server TCP port (default 4747)\n");
+    printf("  --host ADDR       Server IPv4 address (default 127.0.0.1)\n");
+    printf("  --unix PATH       Connect to a UNIX socket instead of TCP\n");
+    printf("  --clients N       Simultaneous games (default 100)\n");
+    printf("  --seconds S       Length of the run (default 10)\n");
+    printf("  --engine SPEC     Engine asked for in every game (default minimax:8)\n");
+    printf("  --seed N          Seed for the clients' moves (default 1)\n");
+    printf("  --help            Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    int port = 4747;
+    const char *host = "127.0.0.1";
+    const char *unixPath = NULL;
+    int clients = 100;
+    int seconds = 10;
+    int seed = 1;
+    LoadStats st;
+    memset(&st, 0, sizeof(st));
+    st.engine = "minimax:8";
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--port") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &port) && port < 65536) {
+            i++;
+        } else if (strcmp(arg, "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (strcmp(arg, "--unix") == 0 && i + 1 < argc) {
+            unixPath = argv[++i];
+        } else if (strcmp(arg, "--clients") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &clients) && clients > 0) {
+            i++;
+        } else if (strcmp(arg, "--seconds") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seconds) && seconds > 0) {
+            i++;
+        } else if (strcmp(arg, "--engine") == 0 && i + 1 < argc) {
+            st.engine = argv[++i];
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seed)) {
+            i++;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+
+    int epfd = epoll_create1(0);
+    Client *pool = calloc((size_t)clients, sizeof(Client));
+    if (epfd < 0 || !pool) return 1;
+
+    for (int i = 0; i < clients; i++) {
+        Client *c = &pool[i];
+        c->fd = connectClient(unixPath, host, port);
+        if (c->fd < 0) {
+            fprintf(stderr, "Could not connect client %d: %s\n", i + 1, strerror(errno));
+            for (int k = 0; k < i; k++) close(pool[k].fd);
+            free(pool);
+            return 1;
+        }
+        rl_rng_seed(&c->rng, ((uint64_t)seed << 32) ^ (uint64_t)i);
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        epoll_ctl(epfd, EPOLL_CTL_ADD, c->fd, &ev);
+    }
+
+    // Every client starts its first game, then reacts to replies
+    double start = timeNow();
+    double deadline = start + seconds;
+    for (int i = 0; i < clients; i++) {
+        if (!newGame(&pool[i], &st)) dropClient(epfd, &pool[i], &st);
+    }
+
+    struct epoll_event events[LOAD_EVENTS];
+    int live = clients - st.failed;
+    while (live > 0) {
+        double now = timeNow();
+        if (now >= deadline) break;
+        int timeout = (int)((deadline - now) * 1000.0) + 1;
+        int n = epoll_wait(epfd, events, LOAD_EVENTS, timeout);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            break;
+        }
+        for (int i = 0; i < n; i++) {
+            Client *c = events[i].data.ptr;
+            if (c->fd < 0) continue;
+            onReadable(epfd, c, &st, timeNow() < deadline);
+            if (c->fd < 0) live--;
+        }
+    }
+    double secs = timeNow() - start;
+
+    printReport(&st, clients, secs);
+
+    for (int i = 0; i < clients; i++) {
+        if (pool[i].fd >= 0) close(pool[i].fd);
+    }
+    close(epfd);
+    free(pool);
+    free(st.latency);
+    return (st.failed > 0) ? 1 : 0;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "c4_load needs Linux (epoll).\n");
+    return 1;
+}
+
+#endif
@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <ctype.h>
+#include <string.h>
+
+#include "connect_four.h"
+#include "console.h"
+#include "engine.h"
+#include "rl_agent.h"
+#include "book.h"
+#include "ponder.h"
+#include "searchstats.h"
+#include "timeutil.h"
+
+// -------- Ask user if they want to play again --------
+static int askPlayAgain(void) {
+    char buf[16];
+
+    while (1) {
+        printf("\nPlay again? (y/n): ");
+        if (!fgets(buf, sizeof(buf), stdin)) {
+            // Input error / EOF: treat as "no"
+            return 0;
+        }
+
+        // Skip leading whitespace
+        char *p = buf;
+        while (*p && isspace((unsigned char)*p)) p++;
+
+        if (*p == 'y' || *p == 'Y') {
+            return 1;
+        } else if (*p == 'n' || *p == 'N') {
+            return 0;
+        } else {
+            printf("Please enter 'y' or 'n'.\n");
+        }
+    }
+}
+
+// ---------------- Session ----------------
+
+#define MODEL_PATH "c4_model.bin"
+
+// Alpha-beta depth of the self-learning AI in mode 3
+#define RL_PLAY_DEPTH 3
+
+// Seconds between background checkpoints of MODEL_PATH while training
+#define RL_CHECKPOINT_SECS 60
+
+// Everything the interactive game owns; the engines keep no state of
+// their own outside these contexts.
+typedef struct {
+    C4Engine    cpu;            // minimax CPU (mode 2)
+    C4Engine    rl;             // search settings of the self-learning AI (mode 3)
+    RLAgent    *agent;          // on the heap: N-tuple tables are large
+    int         rlModel;        // asked for on the command line, -1 = as saved
+    int         checkpointSecs;
+
+    Book        book;
+    const char *bookPath;
+
+    int         threads;        // search and training threads
+    int         ponder;         // minimax CPU searches during the human's turn
+    int         seedSet;
+    unsigned int seed;
+    RLRng       rng;            // training seeds
+
+    const char *statsLogPath;   // one JSON line per AI move (NULL = off)
+    FILE       *statsLog;
+} Session;
+
+static const char *modelName(int model) {
+    return (model == RL_MODEL_NTUPLE) ? "N-tuple" : "linear";
+}
+
+static void logMoveStats(Session *s, const SearchStats *st) {
+    if (!s->statsLog) return;
+    searchStatsWriteJSON(st, s->statsLog);
+    fflush(s->statsLog);
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --hash MB       CPU transposition table size in MB (default 16, 0 = off)\n");
+    printf("  --movetime MS   CPU time budget per move (iterative deepening)\n");
+    printf("  --nodes N       CPU node budget per move (iterative deepening)\n");
+    printf("  --threads N     CPU search / self-play training threads (default 1)\n");
+    printf("  --rl-depth N    Self-learning AI search depth (default %d)\n", RL_PLAY_DEPTH);
+    printf("  --rl-movetime MS  Self-learning AI time budget per move (deepens up to --rl-depth)\n");
+    printf("  --checkpoint S  Save the model every S seconds while training (default %d, 0 = off)\n",
+           RL_CHECKPOINT_SECS);
+    printf("  --rl-model KIND Self-learning model: linear or ntuple (default: as saved, else linear)\n");
+    printf("  --ponder        Let the CPU search the replies while you think\n");
+    printf("  --seed N        Random seed (reproducible CPU tie-breaks and training)\n");
+    printf("  --book PATH     Opening book file (default %s, \"none\" = off)\n", BOOK_PATH_DEFAULT);
+    printf("  --stats-log PATH  Append a JSON line of search statistics per AI move (\"-\" = stderr)\n");
+    printf("  --help          Show this help\n");
+}
+
+// Parse a non-negative integer option value; returns 0 on bad input.
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+// Returns 1 to continue, 0 to exit with `*status`.
+static int parseArgs(Session *s, int argc, char **argv, int *status) {
+    int moveTimeMs = 0;
+    int nodeLimit = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        int value = 0;
+
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            *status = 0;
+            return 0;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value)) {
+            i++;
+            if (!setCPUHashSize(&s->cpu, value)) {
+                fprintf(stderr, "Could not allocate a %d MB transposition table.\n", value);
+                *status = 1;
+                return 0;
+            }
+        } else if (strcmp(arg, "--movetime") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &moveTimeMs)) {
+            i++;
+        } else if (strcmp(arg, "--nodes") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &nodeLimit)) {
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value)) {
+            i++;
+            s->threads = setCPUThreads(&s->cpu, value);
+        } else if (strcmp(arg, "--rl-depth") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value) && value >= 1) {
+            i++;
+            s->rl.depth = value;
+        } else if (strcmp(arg, "--rl-movetime") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value)) {
+            i++;
+            setCPUSearchBudget(&s->rl, value, 0);
+        } else if (strcmp(arg, "--checkpoint") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value)) {
+            i++;
+            s->checkpointSecs = value;
+        } else if (strcmp(arg, "--rl-model") == 0 && i + 1 < argc &&
+                   (strcmp(argv[i + 1], "linear") == 0 || strcmp(argv[i + 1], "ntuple") == 0)) {
+            s->rlModel = (strcmp(argv[++i], "ntuple") == 0) ? RL_MODEL_NTUPLE : RL_MODEL_LINEAR;
+        } else if (strcmp(arg, "--ponder") == 0) {
+            s->ponder = 1;
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &value)) {
+            i++;
+            s->seed = (unsigned int)value;
+            s->seedSet = 1;
+        } else if (strcmp(arg, "--book") == 0 && i + 1 < argc) {
+            s->bookPath = argv[++i];
+        } else if (strcmp(arg, "--stats-log") == 0 && i + 1 < argc) {
+            s->statsLogPath = argv[++i];
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            *status = 1;
+            return 0;
+        }
+    }
+
+    setCPUSearchBudget(&s->cpu, moveTimeMs, nodeLimit);
+    return 1;
+}
+
+// ---------------- Self-learning agent ----------------
+
+static void initAgent(Session *s, int model) {
+    if (model == RL_MODEL_NTUPLE) rl_init_ntuple(s->agent);
+    else                          rl_init(s->agent);
+}
+
+static int fileExists(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (fp) fclose(fp);
+    return fp != NULL;
+}
+
+// Init + load the self-learning agent. A model file that cannot be loaded,
+// or holds another kind than the one asked for, is never replaced: the game
+// refuses to start rather than overwrite it after the first game.
+static int loadAgent(Session *s) {
+    RLAgent *a = s->agent;
+    initAgent(s, s->rlModel);
+    if (rl_load(a, MODEL_PATH)) {
+        if (s->rlModel >= 0 && a->model != s->rlModel) {
+            fprintf(stderr, "%s holds a %s model, not %s. Move it aside to start a fresh one.\n",
+                    MODEL_PATH, modelName(a->model), modelName(s->rlModel));
+            return 0;
+        }
+        printf("Loaded %s self-learning model from %s\n", modelName(a->model), MODEL_PATH);
+    } else if (fileExists(MODEL_PATH)) {
+        fprintf(stderr, "Could not load the self-learning model %s (damaged or from a newer version).\n"
+                        "Move it aside to start a fresh one.\n", MODEL_PATH);
+        return 0;
+    } else {
+        printf("No self-learning model found at %s. Starting fresh (%s).\n",
+               MODEL_PATH, modelName(a->model));
+    }
+    rl_set_checkpoint(a, MODEL_PATH, s->checkpointSecs);
+
+    // A training run cut short after a checkpoint picks up where it was
+    if (a->run.games > 0) {
+        printf("Resuming interrupted training (%d of %d games done)...\n",
+               a->run.done, a->run.games);
+        rl_train_resume(a);
+        if (!rl_save_if_changed(a, MODEL_PATH)) {
+            printf("Failed to save model to %s\n", MODEL_PATH);
+        }
+    }
+    return 1;
+}
+
+static void trainAgent(Session *s) {
+    int games = promptTrainingGames();
+    printf("\nTraining self-learning AI for %d games on %d thread%s...\n",
+           games, s->threads, s->threads == 1 ? "" : "s");
+    double start = timeNow();
+    rl_train_selfplay_mt(s->agent, games, s->threads, rl_rng_next(&s->rng));
+    double secs = timeNow() - start;
+    printf("Played %d games in %.1f s (%.0f games/s)\n",
+           games, secs, (secs > 0.0) ? games / secs : 0.0);
+    if (rl_save_if_changed(s->agent, MODEL_PATH)) {
+        printf("Training complete. Saved model to %s\n", MODEL_PATH);
+    } else {
+        printf("Training complete, but failed to save model to %s\n", MODEL_PATH);
+    }
+    printf("\nNow that it has saved, you will play against it.\n");
+}
+
+// ---------------- One game ----------------
+
+static void playGame(Session *s, int mode, int color) {
+    char board[ROWS][COLS];
+    initializeBoard(board);
+
+    char currentPlayer = PLAYER1;
+    Ponder ponder;
+    int pondered = -1;   // CPU reply found while the human thought
+
+    // Single-game loop
+    while (1) {
+        displayBoard(board, color);
+
+        int col = 0;
+
+        if (currentPlayer == PLAYER2) {
+            if (mode == 2) {
+                // Minimax CPU
+                if (pondered >= 0) {
+                    col = pondered;
+                    printf("CPU chooses column %d (pondered)\n", col + 1);
+                } else {
+                    col = getCPUMove(&s->cpu, board, currentPlayer);
+                    printf("CPU chooses column %d\n", col + 1);
+                }
+                reportCPUSearchStats(&s->cpu);
+                logMoveStats(s, &s->cpu.stats);
+            } else if (mode == 3) {
+                // Self-learning AI
+                col = rl_choose_move(s->agent, &s->rl, board, currentPlayer, 0.0);
+                printf("SelfLearn AI chooses column %d\n", col + 1);
+                searchStatsPrint(&s->rl.stats, stdout);
+                logMoveStats(s, &s->rl.stats);
+            } else {
+                // HvH: PLAYER2 is a human
+                col = getHumanMove(board, currentPlayer);
+            }
+        } else {
+            // PLAYER1 is always human in these modes
+            int pondering = (mode == 2 && s->ponder) &&
+                            ponderStart(&ponder, &s->cpu, board, PLAYER2);
+            col = getHumanMove(board, currentPlayer);
+            pondered = pondering ? ponderStop(&ponder, col) : -1;
+        }
+
+        int row = dropPiece(board, col, currentPlayer);
+
+        if (checkWin(board, currentPlayer, row, col)) {
+            displayBoardWin(board, currentPlayer, row, col);
+            if ((mode == 2 || mode == 3) && currentPlayer == PLAYER2) {
+                printf("%s (%c) wins!\n", (mode == 2) ? "CPU" : "SelfLearn AI", currentPlayer);
+            } else {
+                printf("Player %c wins!\n", currentPlayer);
+            }
+            break;
+        }
+
+        if (isBoardFull(board)) {
+            displayBoard(board, color);
+            printf("It's a draw!\n");
+            break;
+        }
+
+        currentPlayer = (currentPlayer == PLAYER1) ? PLAYER2 : PLAYER1;
+    }
+}
+
+// ---------------- main ----------------
+
+static void closeSession(Session *s) {
+    bookClose(&s->book);
+    if (s->statsLog && s->statsLog != stderr) fclose(s->statsLog);
+    freeCPUEngine(&s->cpu);
+    freeCPUEngine(&s->rl);
+    free(s->agent);
+}
+
+int main(int argc, char **argv) {
+    Session s;
+    memset(&s, 0, sizeof(s));
+    initCPUEngine(&s.cpu);
+    initCPUEngine(&s.rl);
+    s.rl.depth = RL_PLAY_DEPTH;
+    s.rlModel = -1;
+    s.checkpointSecs = RL_CHECKPOINT_SECS;
+    s.bookPath = BOOK_PATH_DEFAULT;
+    s.threads = 1;
+
+    s.agent = malloc(sizeof(RLAgent));
+    if (!s.agent) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    int status = 0;
+    if (!parseArgs(&s, argc, argv, &status)) {
+        closeSession(&s);
+        return status;
+    }
+
+    // Seed CPU move tie-breaking, RL exploration and training
+    if (!s.seedSet) s.seed = (unsigned int)time(NULL);
+    seedCPUEngine(&s.cpu, s.seed);
+    seedCPUEngine(&s.rl, (uint64_t)s.seed + 1);
+    rl_rng_seed(&s.rng, (uint64_t)s.seed + 2);
+
+    if (!loadAgent(&s)) {
+        closeSession(&s);
+        return 1;
+    }
+
+    // Map the opening book (silently optional unless asked for explicitly)
+    if (strcmp(s.bookPath, "none") != 0) {
+        if (bookOpen(&s.book, s.bookPath)) {
+            printf("Loaded opening book %s (%llu positions, up to ply %d)\n",
+                   s.bookPath, (unsigned long long)s.book.count, s.book.maxPly);
+            setCPUBook(&s.cpu, &s.book);
+            setCPUBook(&s.rl, &s.book);
+        } else if (strcmp(s.bookPath, BOOK_PATH_DEFAULT) != 0) {
+            fprintf(stderr, "Could not open opening book %s\n", s.bookPath);
+            closeSession(&s);
+            return 1;
+        }
+    }
+
+    if (s.statsLogPath) {
+        s.statsLog = (strcmp(s.statsLogPath, "-") == 0) ? stderr : fopen(s.statsLogPath, "a");
+        if (!s.statsLog) {
+            fprintf(stderr, "Could not open statistics log %s\n", s.statsLogPath);
+            closeSession(&s);
+            return 1;
+        }
+    }
+
+    // Outer loop: repeat whole games
+    do {
+        int mode = selectGameMode();
+
+        // If minimax CPU mode, let user choose difficulty (depth)
+        if (mode == 2) {
+            setCPUDepth(&s.cpu, selectCPUDifficulty());
+        }
+
+        // Select whether or not to play with color
+        int color = selectColorMode();
+
+        // Training mode (self-play)
+        if (mode == 4) {
+            trainAgent(&s);
+            // After training, immediately let the user play against it
+            mode = 3;
+        }
+
+        playGame(&s, mode, color);
+
+        // Save model (skipped when unchanged)
+        rl_save_if_changed(s.agent, MODEL_PATH);
+
+    } while (askPlayAgain());
+
+    closeSession(&s);
+    printf("Thanks for playing!\n");
+    return 0;
+}
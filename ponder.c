@@ -0,0 +1,76 @@
+#include <string.h>
+#include "ponder.h"
+
+static const int ponderOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+static void *ponderMain(void *arg) {
+    Ponder *p = arg;
+    C4Engine *e = p->engine;
+    char human = (p->cpuPiece == PLAYER1) ? PLAYER2 : PLAYER1;
+    char board[ROWS][COLS];
+
+    for (int i = 0; i < p->orderCount; i++) {
+        int col = p->order[i];
+        memcpy(board, p->board, sizeof(board));
+        int row = dropPiece(board, col, human);
+        // Nothing to answer after a winning or last move
+        if (checkWin(board, human, row, col) || isBoardFull(board)) continue;
+
+        // A search that finished before the stop is kept: the human's move
+        // usually arrives right after one
+        int move = getCPUMove(e, board, p->cpuPiece);
+        if (e->lastStopped) break;
+
+        PonderReply *r = &p->replies[col];
+        r->move = move;
+        r->stats = e->stats;
+        r->bookScore = e->lastBookScore;
+        r->ready = 1;
+        if (atomic_load(&p->stop)) break;
+    }
+    return NULL;
+}
+
+int ponderStart(Ponder *p, C4Engine *e, char board[ROWS][COLS], char cpuPiece) {
+    memset(p, 0, sizeof(*p));
+    if (e->useSolver) return 0;
+
+    p->engine = e;
+    memcpy(p->board, board, sizeof(p->board));
+    p->cpuPiece = cpuPiece;
+    atomic_init(&p->stop, 0);
+
+    // The reply the last search expected, if it is still on the board
+    int predicted = (e->stats.pvLength >= 2) ? e->stats.pv[1] : -1;
+    if (predicted >= 0 && isMoveValid(board, predicted)) p->order[p->orderCount++] = predicted;
+    for (int i = 0; i < COLS; i++) {
+        int col = ponderOrder[i];
+        if (col != predicted && isMoveValid(board, col)) p->order[p->orderCount++] = col;
+    }
+    if (p->orderCount == 0) return 0;
+
+    setCPUStopFlag(e, &p->stop);
+    if (pthread_create(&p->thread, NULL, ponderMain, p) != 0) {
+        setCPUStopFlag(e, NULL);
+        return 0;
+    }
+    p->running = 1;
+    return 1;
+}
+
+int ponderStop(Ponder *p, int humanCol) {
+    if (!p->running) return -1;
+    atomic_store(&p->stop, 1);
+    pthread_join(p->thread, NULL);
+    p->running = 0;
+
+    C4Engine *e = p->engine;
+    setCPUStopFlag(e, NULL);
+    if (humanCol < 0 || humanCol >= COLS || !p->replies[humanCol].ready) return -1;
+
+    const PonderReply *r = &p->replies[humanCol];
+    e->stats = r->stats;
+    e->lastBookScore = r->bookScore;
+    e->lastStopped = 0;
+    return r->move;
+}
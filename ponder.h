@@ -0,0 +1,51 @@
+#ifndef PONDER_H
+#define PONDER_H
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include "connect_four.h"
+#include "engine.h"
+
+// =======================================================
+// Pondering: minimax searches during the opponent's turn
+// =======================================================
+//
+// While the human thinks, a background thread runs getCPUMove on the
+// CPU's engine context for the human's replies, the one predicted by the
+// last principal variation first, then the others center-first. Each
+// finished search is kept; the rest of the work stays in the
+// transposition table. Between ponderStart and ponderStop the engine
+// context belongs to the pondering thread. The solver cannot be stopped,
+// so a context set to perfect play is not pondered.
+
+typedef struct {
+    int         ready;        // the search for this reply finished
+    int         move;
+    SearchStats stats;
+    int         bookScore;
+} PonderReply;
+
+typedef struct {
+    C4Engine   *engine;
+    char        board[ROWS][COLS];   // before the human's move
+    char        cpuPiece;
+    int         order[COLS];         // replies in search order
+    int         orderCount;
+
+    pthread_t   thread;
+    int         running;
+    atomic_int  stop;
+
+    PonderReply replies[COLS];
+} Ponder;
+
+// Start pondering on `board` with the human (the other piece) to move.
+// Returns 0 if nothing is pondered.
+int  ponderStart(Ponder *p, C4Engine *e, char board[ROWS][COLS], char cpuPiece);
+
+// Stop pondering and hand the engine context back. If the search for the
+// human's move `humanCol` finished, its move is returned and its
+// statistics are put in the context; otherwise -1.
+int  ponderStop(Ponder *p, int humanCol);
+
+#endif
@@ -1,31 +1,70 @@
 #include "rl_agent.h"
+#include "engine.h"
+#include "bitboard.h"
+#include "windows.h"
+#include "book.h"
+#include "gamelog.h"
+#include "searchstats.h"
+#include "timeutil.h"
+#include <limits.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdint.h>
+#include <pthread.h>
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 #define RL_INF 1e100
 
-static char otherPlayer(char p) { return (p == PLAYER1) ? PLAYER2 : PLAYER1; }
+// Positions per feature block in rl_value_batch
+#define RL_BATCH_BLOCK 256
 
-static void copyBoard(char dst[ROWS][COLS], char src[ROWS][COLS]) {
-    memcpy(dst, src, sizeof(char) * ROWS * COLS);
+// Games each training worker plays per round before the deltas are merged
+#define RL_TRAIN_BATCH 256
+
+void rl_set_game_log(RLAgent *a, GameLogWriter *log) {
+    a->gameLog = log;
 }
 
-static int isMoveValidRL(char board[ROWS][COLS], int col) {
-    return (col >= 0 && col < COLS && board[0][col] == EMPTY);
+// ---------- Random numbers ----------
+
+static uint64_t splitmix64(uint64_t *x) {
+    uint64_t z = (*x += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
 }
 
-static int getLandingRow(char board[ROWS][COLS], int col) {
-    for (int r = ROWS - 1; r >= 0; r--) {
-        if (board[r][col] == EMPTY) return r;
-    }
-    return -1;
+void rl_rng_seed(RLRng *r, uint64_t seed) {
+    r->state = splitmix64(&seed);
+    if (r->state == 0) r->state = 0x2545F4914F6CDD1DULL;   // xorshift must not be 0
+}
+
+uint32_t rl_rng_next(RLRng *r) {
+    // xorshift64*
+    uint64_t x = r->state;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    r->state = x;
+    return (uint32_t)((x * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+double rl_rng_uniform(RLRng *r) {
+    return rl_rng_next(r) / 4294967296.0;
+}
+
+static double randUniform(RLRng *rng) {
+    return rl_rng_uniform(rng);
 }
 
-static int isPlayableCell(char board[ROWS][COLS], int r, int c) {
-    if (board[r][c] != EMPTY) return 0;
-    return (r == ROWS - 1 || board[r + 1][c] != EMPTY);
+static int randIndex(RLRng *rng, int n) {
+    return (int)(rl_rng_next(rng) % (uint32_t)n);
 }
 
 static double dot(const double *w, const double *x) {
@@ -41,22 +80,6 @@ static void clampWeights(RLAgent *a) {
     }
 }
 
-// Count immediate winning moves available to `piece` on this board.
-static int countImmediateWins(char board[ROWS][COLS], char piece) {
-    int count = 0;
-    for (int c = 0; c < COLS; c++) {
-        int r = getLandingRow(board, c);
-        if (r < 0) continue;
-        board[r][c] = piece;
-        {
-            int win = checkWin(board, piece, r, c);
-            board[r][c] = EMPTY;
-            if (win) count++;
-        }
-    }
-    return count;
-}
-
 /*
 Features (RL_FEATURES = 14):
 0  bias
@@ -75,91 +98,287 @@ Features (RL_FEATURES = 14):
 13 opp 1+3 potential
 */
 
-static void score_window(char board[ROWS][COLS], char me, char opp,
-                         double f[RL_FEATURES],
-                         int r0, int c0, int dr, int dc) {
-    int meCount = 0, oppCount = 0, emptyCount = 0;
-    int playableEmpty = 0;
-
-    for (int i = 0; i < 4; i++) {
-        int r = r0 + i * dr;
-        int c = c0 + i * dc;
-        char cell = board[r][c];
-
-        if (cell == me) meCount++;
-        else if (cell == opp) oppCount++;
-        else {
-            emptyCount++;
-            if (isPlayableCell(board, r, c)) playableEmpty++;
+// Window classes feeding the features, per player p: a "clean" window
+// (no stones of the other player) holding 3, 2 or 1 of p's stones.
+// Classes from WC_TWO up depend on whether an empty cell is playable.
+enum {
+    WC_NONE,
+    WC_ONE,                 // 1+3
+    WC_TWO,                 // 2+2, no empty cell playable
+    WC_TWO_PLAYABLE,        // 2+2, >=1 empty cell playable
+    WC_THREE,               // 3+1, not playable yet
+    WC_THREE_PLAYABLE,      // 3+1, the empty cell is playable
+    WC_COUNT
+};
+
+// Feature index of each class for "me" and for the opponent
+static const int meFeature[WC_COUNT]  = {-1, 12, 5, 4, 3, 2};
+static const int oppFeature[WC_COUNT] = {-1, 13, 9, 8, 7, 6};
+
+// Class by [own stones][other stones][any empty cell playable]. Only
+// "clean" windows (no mixed pieces) count.
+static const int8_t windowClassTable[5][5][2] = {
+    [1][0] = {WC_ONE,   WC_ONE},
+    [2][0] = {WC_TWO,   WC_TWO_PLAYABLE},
+    [3][0] = {WC_THREE, WC_THREE_PLAYABLE},
+};
+
+static int windowClass(int ownCount, int otherCount, int playableEmpty) {
+    return windowClassTable[ownCount][otherCount][playableEmpty];
+}
+
+// Fill the feature vector from per-player class counts and center stones;
+// the immediate-win counts come straight from the bitboard.
+static void assembleFeatures(const Bitboard *bb, int me,
+                             const int classCount[2][WC_COUNT],
+                             const int centerCount[2],
+                             double f[RL_FEATURES]) {
+    memset(f, 0, sizeof(double) * RL_FEATURES);
+    f[0] = 1.0;
+    f[1] = (double)(centerCount[me] - centerCount[me ^ 1]);
+
+    for (int k = WC_ONE; k < WC_COUNT; k++) {
+        f[meFeature[k]]  = (double)classCount[me][k];
+        f[oppFeature[k]] = (double)classCount[me ^ 1][k];
+    }
+
+    // Immediate win counts (very important tactical signal). There is one
+    // playable cell per column, so this counts winning columns.
+    uint64_t occupied = bbOccupied(bb);
+    uint64_t playable = bbPlayableCells(bb);
+    f[10] = (double)bbPopcount(bbWinningCells(bb->pieces[me], occupied) & playable);
+    f[11] = (double)bbPopcount(bbWinningCells(bb->pieces[me ^ 1], occupied) & playable);
+}
+
+// Features of a bitboard position from player index `me`'s point of view,
+// computed from scratch.
+static void bitboardFeatures(const Bitboard *bb, int me, double f[RL_FEATURES]) {
+    const WindowTable *wt = windowTable();
+    uint64_t playable = bbPlayableCells(bb);
+    uint64_t center = BB_COLUMN_MASK(COLS / 2);
+
+    int classCount[2][WC_COUNT] = {{0}};
+    int centerCount[2];
+    for (int p = 0; p < 2; p++) {
+        centerCount[p] = bbPopcount(bb->pieces[p] & center);
+    }
+
+    // Scan windows
+    for (int w = 0; w < NUM_WINDOWS; w++) {
+        uint64_t mask = wt->windows[w].mask;
+        int counts[2] = { bbPopcount(bb->pieces[0] & mask), bbPopcount(bb->pieces[1] & mask) };
+        int playableEmpty = (playable & mask) != 0;
+        for (int p = 0; p < 2; p++) {
+            classCount[p][windowClass(counts[p], counts[p ^ 1], playableEmpty)]++;
         }
     }
 
-    // Only count "clean" windows (no mixed pieces)
-    if (oppCount == 0) {
-        if (meCount == 3 && emptyCount == 1) {
-            if (playableEmpty) f[2] += 1.0;
-            else               f[3] += 1.0;
-        } else if (meCount == 2 && emptyCount == 2) {
-            if (playableEmpty) f[4] += 1.0;
-            else               f[5] += 1.0;
-        } else if (meCount == 1 && emptyCount == 3) {
-            f[12] += 1.0;
+    assembleFeatures(bb, me, (const int (*)[WC_COUNT])classCount, centerCount, f);
+}
+
+static void extractFeatures(char board[ROWS][COLS], char me, double f[RL_FEATURES]) {
+    Bitboard bb;
+    bbFromBoard(&bb, board);
+    bitboardFeatures(&bb, bbIndex(me), f);
+}
+
+// ---------- N-tuple network ----------
+
+// A cell lies in at most 16 lines and 6 blocks
+#define RL_NT_MAX_CELL_TUPLES (MAX_CELL_WINDOWS + 6)
+
+// Trace below which an old state is left out of a TD(lambda) update
+#define RL_NT_TRACE_MIN 1e-3
+
+// Where each cell sits in the tuples. A tuple's pattern index is the sum
+// of pow * (1 = side to move, 2 = other side) over its occupied cells, so a
+// stone changes each tuple index through its cell by a single addition.
+typedef struct {
+    int      offset[RL_NT_TUPLES];    // first entry of each tuple's table in nt[]
+    uint8_t  cellTuple[ROWS][COLS][RL_NT_MAX_CELL_TUPLES];
+    uint16_t cellPow[ROWS][COLS][RL_NT_MAX_CELL_TUPLES];   // 3^(cell position in tuple)
+    uint8_t  cellTupleCount[ROWS][COLS];
+} NTupleTable;
+
+static NTupleTable ntTable;
+static pthread_once_t ntTableOnce = PTHREAD_ONCE_INIT;
+
+static void ntAddCell(int t, int r, int c, int pow) {
+    int k = ntTable.cellTupleCount[r][c]++;
+    ntTable.cellTuple[r][c][k] = (uint8_t)t;
+    ntTable.cellPow[r][c][k] = (uint16_t)pow;
+}
+
+static void buildNTupleTable(void) {
+    const WindowTable *wt = windowTable();
+    int t = 0;
+    int offset = 0;
+
+    for (int w = 0; w < NUM_WINDOWS; w++, t++) {
+        ntTable.offset[t] = offset;
+        for (int i = 0, pow = 1; i < 4; i++, pow *= 3) {
+            ntAddCell(t, wt->windows[w].row[i], wt->windows[w].col[i], pow);
         }
+        offset += 81;
     }
 
-    if (meCount == 0) {
-        if (oppCount == 3 && emptyCount == 1) {
-            if (playableEmpty) f[6] += 1.0;
-            else               f[7] += 1.0;
-        } else if (oppCount == 2 && emptyCount == 2) {
-            if (playableEmpty) f[8] += 1.0;
-            else               f[9] += 1.0;
-        } else if (oppCount == 1 && emptyCount == 3) {
-            f[13] += 1.0;
+    for (int r = 0; r + 1 < ROWS; r++) {
+        for (int c = 0; c + 2 < COLS; c++, t++) {
+            ntTable.offset[t] = offset;
+            int pow = 1;
+            for (int dr = 0; dr < 2; dr++) {
+                for (int dc = 0; dc < 3; dc++, pow *= 3) ntAddCell(t, r + dr, c + dc, pow);
+            }
+            offset += 729;
         }
     }
 }
 
-static void extractFeatures(char board[ROWS][COLS], char me, double f[RL_FEATURES]) {
-    char opp = otherPlayer(me);
-    memset(f, 0, sizeof(double) * RL_FEATURES);
-    f[0] = 1.0;
+static const NTupleTable *ntupleTable(void) {
+    pthread_once(&ntTableOnce, buildNTupleTable);
+    return &ntTable;
+}
+
+// Sum of the table entries selected by one side's tuple indices.
+static double ntValue(const RLAgent *a, const uint16_t index[RL_NT_TUPLES]) {
+    float s = 0.0f;
+    for (int t = 0; t < RL_NT_TUPLES; t++) s += a->nt[index[t]];
+    return s;
+}
+
+// ---------- Incremental features ----------
+
+// A bitboard plus the per-window state behind the features. Dropping or
+// removing a stone only revisits the windows through that cell and through
+// the cell above it (whose "playable" flag changes), instead of all 69.
+// For the N-tuple model it keeps the tuple indices instead.
+typedef struct {
+    const WindowTable *wt;
+    Bitboard bb;
+    uint8_t  count[2][NUM_WINDOWS];        // stones per window, by player
+    int8_t   cls[2][NUM_WINDOWS];          // current windowClass per player
+    int      classCount[2][WC_COUNT];
+    int      centerCount[2];
+
+    const NTupleTable *nt;                 // NULL = linear model
+    uint16_t ntIndex[2][RL_NT_TUPLES];     // entry in nt[] per tuple, by side to move
+} RLAccum;
+
+static void accReclassify(RLAccum *acc, int w, uint64_t playable) {
+    int playableEmpty = (playable & acc->wt->windows[w].mask) != 0;
+    for (int p = 0; p < 2; p++) {
+        int k = windowClass(acc->count[p][w], acc->count[p ^ 1][w], playableEmpty);
+        acc->classCount[p][acc->cls[p][w]]--;
+        acc->classCount[p][k]++;
+        acc->cls[p][w] = (int8_t)k;
+    }
+}
+
+// N-tuple indices change by pow for the side that dropped the stone and by
+// 2 * pow for the other side.
+static void accUpdateTuples(RLAccum *acc, int r, int c, int who, int delta) {
+    const NTupleTable *nt = acc->nt;
+    for (int i = 0; i < nt->cellTupleCount[r][c]; i++) {
+        int t = nt->cellTuple[r][c][i];
+        int pow = nt->cellPow[r][c][i] * delta;
+        acc->ntIndex[who][t] = (uint16_t)(acc->ntIndex[who][t] + pow);
+        acc->ntIndex[who ^ 1][t] = (uint16_t)(acc->ntIndex[who ^ 1][t] + 2 * pow);
+    }
+}
+
+static void accInit(RLAccum *acc, const Bitboard *bb, int model) {
+    acc->wt = windowTable();
+    acc->bb = *bb;
 
-    // Center column difference
-    {
-        int center = COLS / 2;
-        int myCenter = 0, oppCenter = 0;
+    if (model == RL_MODEL_NTUPLE) {
+        acc->nt = ntupleTable();
+        for (int t = 0; t < RL_NT_TUPLES; t++) {
+            acc->ntIndex[0][t] = acc->ntIndex[1][t] = (uint16_t)acc->nt->offset[t];
+        }
         for (int r = 0; r < ROWS; r++) {
-            if (board[r][center] == me) myCenter++;
-            else if (board[r][center] == opp) oppCenter++;
+            for (int c = 0; c < COLS; c++) {
+                uint64_t bit = bbCellBit(r, c);
+                if (bb->pieces[0] & bit) accUpdateTuples(acc, r, c, 0, 1);
+                if (bb->pieces[1] & bit) accUpdateTuples(acc, r, c, 1, 1);
+            }
         }
-        f[1] = (double)(myCenter - oppCenter);
+        return;
     }
 
-    // Scan windows
-    for (int r = 0; r < ROWS; r++)
-        for (int c = 0; c <= COLS - 4; c++)
-            score_window(board, me, opp, f, r, c, 0, 1);
+    acc->nt = NULL;
+    memset(acc->classCount, 0, sizeof(acc->classCount));
 
-    for (int c = 0; c < COLS; c++)
-        for (int r = 0; r <= ROWS - 4; r++)
-            score_window(board, me, opp, f, r, c, 1, 0);
+    uint64_t playable = bbPlayableCells(bb);
+    uint64_t center = BB_COLUMN_MASK(COLS / 2);
+    for (int p = 0; p < 2; p++) {
+        acc->centerCount[p] = bbPopcount(bb->pieces[p] & center);
+    }
+    for (int w = 0; w < NUM_WINDOWS; w++) {
+        uint64_t mask = acc->wt->windows[w].mask;
+        acc->count[0][w] = (uint8_t)bbPopcount(bb->pieces[0] & mask);
+        acc->count[1][w] = (uint8_t)bbPopcount(bb->pieces[1] & mask);
+        acc->cls[0][w] = acc->cls[1][w] = WC_NONE;
+        acc->classCount[0][WC_NONE]++;
+        acc->classCount[1][WC_NONE]++;
+        accReclassify(acc, w, playable);
+    }
+}
 
-    for (int r = 0; r <= ROWS - 4; r++)
-        for (int c = 0; c <= COLS - 4; c++)
-            score_window(board, me, opp, f, r, c, 1, 1);
+// Stone of `who` added (delta 1) or removed (delta -1) at (r,c); the
+// bitboard already reflects the change.
+static void accUpdate(RLAccum *acc, int r, int c, int who, int delta) {
+    if (acc->nt) {
+        accUpdateTuples(acc, r, c, who, delta);
+        return;
+    }
+
+    const WindowTable *wt = acc->wt;
+    uint64_t playable = bbPlayableCells(&acc->bb);
 
-    for (int r = 3; r < ROWS; r++)
-        for (int c = 0; c <= COLS - 4; c++)
-            score_window(board, me, opp, f, r, c, -1, 1);
+    for (int i = 0; i < wt->cellWindowCount[r][c]; i++) {
+        int w = wt->cellWindows[r][c][i];
+        acc->count[who][w] = (uint8_t)(acc->count[who][w] + delta);
+        accReclassify(acc, w, playable);
+    }
+    if (r > 0) {
+        // Only the playable flag changed here, which matters for 2s and 3s
+        for (int i = 0; i < wt->cellWindowCount[r - 1][c]; i++) {
+            int w = wt->cellWindows[r - 1][c][i];
+            if (acc->cls[0][w] >= WC_TWO || acc->cls[1][w] >= WC_TWO) {
+                accReclassify(acc, w, playable);
+            }
+        }
+    }
+    if (c == COLS / 2) acc->centerCount[who] += delta;
+}
 
-    // Immediate win counts (very important tactical signal)
-    f[10] = (double)countImmediateWins(board, me);
-    f[11] = (double)countImmediateWins(board, opp);
+static void accPlay(RLAccum *acc, int c, int who) {
+    int r = bbLandingRow(&acc->bb, c);
+    bbPlay(&acc->bb, c, who);
+    accUpdate(acc, r, c, who, 1);
+}
+
+static void accUndo(RLAccum *acc, int c, int who) {
+    bbUndo(&acc->bb, c, who);
+    accUpdate(acc, bbLandingRow(&acc->bb, c), c, who, -1);
+}
+
+static void accFeatures(const RLAccum *acc, int me, double f[RL_FEATURES]) {
+    assembleFeatures(&acc->bb, me, acc->classCount, acc->centerCount, f);
+}
+
+static double accValue(const RLAgent *a, const RLAccum *acc, int me) {
+    if (acc->nt) return ntValue(a, acc->ntIndex[me]);
+
+    double f[RL_FEATURES];
+    accFeatures(acc, me, f);
+    return dot(a->w, f);
 }
 
 void rl_init(RLAgent *a) {
+    a->model = RL_MODEL_LINEAR;
     for (int i = 0; i < RL_FEATURES; i++) a->w[i] = 0.0;
+    memset(a->nt, 0, sizeof(a->nt));
 
     // Helpful initial biases (not required, but speeds up learning)
     a->w[1]  = 0.3;   // center
@@ -170,274 +389,1071 @@ void rl_init(RLAgent *a) {
 
     // Learning params (good defaults)
     a->alpha   = 0.004;
+    a->ntAlpha = 0.0005;  // a value sums RL_NT_TUPLES entries; 0.001 diverges
     a->gamma   = 0.99;
     a->lambda  = 0.85;
     a->epsilon = 0.25;
+
+    a->gamesTrained = 0;
+    memset(&a->run, 0, sizeof(a->run));
+    a->savedSum = 0;
+
+    a->gameLog = NULL;
+    a->checkpointPath = NULL;
+    a->checkpointSecs = 0;
+}
+
+void rl_init_ntuple(RLAgent *a) {
+    rl_init(a);
+    a->model = RL_MODEL_NTUPLE;
 }
 
 /*
-Model save format (versioned):
+Model save format (versioned, native byte order):
 magic "C4RL"
-u32 version (2)
+u32 version (4; version 2 files end after the weights, version 3 files
+             have sections but no checksum)
 u32 features (RL_FEATURES)
 then weights[RL_FEATURES] (double)
+then sections, each:
+  char tag[4], u32 section version, u32 payload bytes, payload
+  "META" v1: double alpha, ntAlpha, gamma, lambda, epsilon
+             u64 gamesTrained
+             i32 run games, run done, run threads, 0
+             double run epsStart
+             u64 rng state[run threads]
+  "NTUP" v1: u32 tuples (RL_NT_TUPLES), float nt[RL_NT_WEIGHTS]
+  "CSUM" v1: u64 FNV-1a hash of every byte before this section; always
+             last, so a truncated or damaged file is rejected
+Unknown sections are skipped; an NTUP section makes it an N-tuple model.
 */
-int rl_save(const RLAgent *a, const char *path) {
-    FILE *fp = fopen(path, "wb");
-    if (!fp) return 0;
+#define RL_MODEL_VERSION 4
+#define RL_META_SECTION_VERSION 1
+#define RL_NTUPLE_SECTION_VERSION 1
+#define RL_CSUM_SECTION_VERSION 1
+
+#define RL_SECTION_HEADER 12
+#define RL_META_BYTES(threads) (5 * 8 + 8 + 4 * 4 + 8 + 8 * (size_t)(threads))
+#define RL_NTUP_BYTES (4 + sizeof(float) * RL_NT_WEIGHTS)
+#define RL_CSUM_BYTES 8
+
+// Largest file rl_save writes
+#define RL_MODEL_MAX_BYTES (12 + sizeof(double) * RL_FEATURES + \
+                            RL_SECTION_HEADER + RL_META_BYTES(RL_MAX_THREADS) + \
+                            RL_SECTION_HEADER + RL_NTUP_BYTES + \
+                            RL_SECTION_HEADER + RL_CSUM_BYTES)
+
+// Files larger than this are not model files
+#define RL_MODEL_READ_LIMIT (16u << 20)
+
+static uint64_t fnv1a(const uint8_t *data, size_t len) {
+    uint64_t h = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= data[i];
+        h *= 0x100000001B3ULL;
+    }
+    return h;
+}
 
-    {
-        const char magic[4] = {'C','4','R','L'};
-        uint32_t ver = 2;
-        uint32_t feat = (uint32_t)RL_FEATURES;
+typedef struct {
+    uint8_t *data;
+    size_t   len;
+} ModelWriter;
 
-        if (fwrite(magic, 1, 4, fp) != 4) { fclose(fp); return 0; }
-        if (fwrite(&ver, sizeof(ver), 1, fp) != 1) { fclose(fp); return 0; }
-        if (fwrite(&feat, sizeof(feat), 1, fp) != 1) { fclose(fp); return 0; }
-    }
+static void putBytes(ModelWriter *w, const void *src, size_t n) {
+    memcpy(w->data + w->len, src, n);
+    w->len += n;
+}
 
-    if (fwrite(a->w, sizeof(double), RL_FEATURES, fp) != RL_FEATURES) {
-        fclose(fp);
-        return 0;
+static void putU32(ModelWriter *w, uint32_t v) { putBytes(w, &v, sizeof(v)); }
+static void putI32(ModelWriter *w, int32_t v)  { putBytes(w, &v, sizeof(v)); }
+static void putU64(ModelWriter *w, uint64_t v) { putBytes(w, &v, sizeof(v)); }
+static void putF64(ModelWriter *w, double v)   { putBytes(w, &v, sizeof(v)); }
+
+static void putSection(ModelWriter *w, const char tag[4], uint32_t ver, size_t bytes) {
+    putBytes(w, tag, 4);
+    putU32(w, ver);
+    putU32(w, (uint32_t)bytes);
+}
+
+// Serialise `a` into `data` (RL_MODEL_MAX_BYTES). Returns the size and
+// the file checksum.
+static size_t serializeModel(const RLAgent *a, uint8_t *data, uint64_t *sum) {
+    ModelWriter w = {data, 0};
+    const RLTrainRun *run = &a->run;
+    int threads = (run->games > 0) ? run->threads : 0;
+
+    putBytes(&w, "C4RL", 4);
+    putU32(&w, RL_MODEL_VERSION);
+    putU32(&w, RL_FEATURES);
+    putBytes(&w, a->w, sizeof(a->w));
+
+    putSection(&w, "META", RL_META_SECTION_VERSION, RL_META_BYTES(threads));
+    putF64(&w, a->alpha);
+    putF64(&w, a->ntAlpha);
+    putF64(&w, a->gamma);
+    putF64(&w, a->lambda);
+    putF64(&w, a->epsilon);
+    putU64(&w, a->gamesTrained);
+    putI32(&w, (threads > 0) ? run->games : 0);
+    putI32(&w, (threads > 0) ? run->done : 0);
+    putI32(&w, threads);
+    putI32(&w, 0);
+    putF64(&w, (threads > 0) ? run->epsStart : 0.0);
+    for (int t = 0; t < threads; t++) putU64(&w, run->rng[t].state);
+
+    if (a->model == RL_MODEL_NTUPLE) {
+        putSection(&w, "NTUP", RL_NTUPLE_SECTION_VERSION, RL_NTUP_BYTES);
+        putU32(&w, RL_NT_TUPLES);
+        putBytes(&w, a->nt, sizeof(a->nt));
     }
 
-    fclose(fp);
+    *sum = fnv1a(data, w.len);
+    putSection(&w, "CSUM", RL_CSUM_SECTION_VERSION, RL_CSUM_BYTES);
+    putU64(&w, *sum);
+    return w.len;
+}
+
+typedef struct {
+    const uint8_t *data;
+    size_t         len;
+    size_t         pos;
+} ModelReader;
+
+static int getBytes(ModelReader *r, void *dst, size_t n) {
+    if (r->len - r->pos < n) return 0;
+    memcpy(dst, r->data + r->pos, n);
+    r->pos += n;
     return 1;
 }
 
-int rl_load(RLAgent *a, const char *path) {
-    FILE *fp = fopen(path, "rb");
-    if (!fp) return 0;
+static int getU32(ModelReader *r, uint32_t *v) { return getBytes(r, v, sizeof(*v)); }
+static int getI32(ModelReader *r, int32_t *v)  { return getBytes(r, v, sizeof(*v)); }
+static int getU64(ModelReader *r, uint64_t *v) { return getBytes(r, v, sizeof(*v)); }
+static int getF64(ModelReader *r, double *v)   { return getBytes(r, v, sizeof(*v)); }
+
+static int readMetaSection(RLAgent *a, ModelReader *r, size_t bytes) {
+    int32_t games, done, threads, pad;
+    if (!getF64(r, &a->alpha) || !getF64(r, &a->ntAlpha) || !getF64(r, &a->gamma) ||
+        !getF64(r, &a->lambda) || !getF64(r, &a->epsilon) || !getU64(r, &a->gamesTrained) ||
+        !getI32(r, &games) || !getI32(r, &done) || !getI32(r, &threads) || !getI32(r, &pad) ||
+        !getF64(r, &a->run.epsStart)) {
+        return 0;
+    }
+    if (threads < 0 || threads > RL_MAX_THREADS || bytes != RL_META_BYTES(threads)) return 0;
+    if (threads > 0 && (games <= 0 || done < 0 || done > games)) return 0;
+
+    a->run.games = (threads > 0) ? games : 0;
+    a->run.done = done;
+    a->run.threads = threads;
+    for (int t = 0; t < threads; t++) {
+        if (!getU64(r, &a->run.rng[t].state)) return 0;
+    }
+    return 1;
+}
 
+// Parse a whole model file into `a`. Returns its format version, or 0 if
+// it is incompatible, truncated or fails its checksum.
+static int parseModel(RLAgent *a, const uint8_t *data, size_t len) {
+    ModelReader r = {data, len, 0};
     char magic[4];
     uint32_t ver = 0, feat = 0;
 
-    if (fread(magic, 1, 4, fp) != 4) { fclose(fp); return 0; }
-    if (memcmp(magic, "C4RL", 4) != 0) { fclose(fp); return 0; }
-    if (fread(&ver, sizeof(ver), 1, fp) != 1) { fclose(fp); return 0; }
-    if (fread(&feat, sizeof(feat), 1, fp) != 1) { fclose(fp); return 0; }
-
-    if (ver != 2 || feat != (uint32_t)RL_FEATURES) {
-        fclose(fp);
+    if (!getBytes(&r, magic, 4) || memcmp(magic, "C4RL", 4) != 0) return 0;
+    if (!getU32(&r, &ver) || !getU32(&r, &feat)) return 0;
+    if (ver < 2 || ver > RL_MODEL_VERSION || feat != (uint32_t)RL_FEATURES) {
         return 0; // incompatible model file
     }
 
-    if (fread(a->w, sizeof(double), RL_FEATURES, fp) != RL_FEATURES) {
+    if (ver >= 4) {
+        // Checksum section at the very end
+        size_t tail = RL_SECTION_HEADER + RL_CSUM_BYTES;
+        if (len < r.pos + tail) return 0;
+        ModelReader t = {data, len, len - tail};
+        char tag[4];
+        uint32_t sver = 0, bytes = 0;
+        uint64_t sum = 0;
+        if (!getBytes(&t, tag, 4) || memcmp(tag, "CSUM", 4) != 0 ||
+            !getU32(&t, &sver) || !getU32(&t, &bytes) || bytes != RL_CSUM_BYTES ||
+            !getU64(&t, &sum) || sum != fnv1a(data, len - tail)) {
+            return 0;
+        }
+        r.len = len - tail;
+    }
+
+    a->model = RL_MODEL_LINEAR;
+    a->gamesTrained = 0;
+    memset(&a->run, 0, sizeof(a->run));
+    if (!getBytes(&r, a->w, sizeof(a->w))) return 0;
+    if (ver == 2) return (int)ver;
+
+    while (r.pos < r.len) {
+        char tag[4];
+        uint32_t sver = 0, bytes = 0;
+        if (!getBytes(&r, tag, 4) || !getU32(&r, &sver) || !getU32(&r, &bytes)) return 0;
+        if (r.len - r.pos < bytes) return 0;
+        size_t end = r.pos + bytes;
+
+        if (memcmp(tag, "META", 4) == 0 && sver == RL_META_SECTION_VERSION) {
+            if (!readMetaSection(a, &r, bytes)) return 0;
+        } else if (memcmp(tag, "NTUP", 4) == 0 && sver == RL_NTUPLE_SECTION_VERSION) {
+            uint32_t tuples = 0;
+            if (bytes != RL_NTUP_BYTES || !getU32(&r, &tuples) || tuples != RL_NT_TUPLES) return 0;
+            if (!getBytes(&r, a->nt, sizeof(a->nt))) return 0;
+            a->model = RL_MODEL_NTUPLE;
+        }
+        r.pos = end;   // skip unknown sections
+    }
+    return (int)ver;
+}
+
+// Write `data` to "<path>.tmp", flush it to disk and rename it over
+// `path`; the old file stays intact until the rename.
+static int writeFileAtomic(const char *path, const uint8_t *data, size_t len) {
+    size_t n = strlen(path) + 5;
+    char *tmp = malloc(n);
+    if (!tmp) return 0;
+    snprintf(tmp, n, "%s.tmp", path);
+
+    FILE *fp = fopen(tmp, "wb");
+    int ok = (fp != NULL);
+    if (ok) {
+        ok = fwrite(data, 1, len, fp) == len && fflush(fp) == 0;
+#ifndef _WIN32
+        if (ok) ok = (fsync(fileno(fp)) == 0);
+#endif
+        if (fclose(fp) != 0) ok = 0;
+    }
+#ifdef _WIN32
+    if (ok) remove(path);   // rename does not replace files on Windows
+#endif
+    if (ok) ok = (rename(tmp, path) == 0);
+    if (!ok) remove(tmp);
+    free(tmp);
+    return ok;
+}
+
+int rl_save(const RLAgent *a, const char *path) {
+    uint8_t *data = malloc(RL_MODEL_MAX_BYTES);
+    if (!data) return 0;
+
+    uint64_t sum;
+    size_t len = serializeModel(a, data, &sum);
+    int ok = writeFileAtomic(path, data, len);
+    free(data);
+    return ok;
+}
+
+int rl_save_if_changed(RLAgent *a, const char *path) {
+    uint8_t *data = malloc(RL_MODEL_MAX_BYTES);
+    if (!data) return 0;
+
+    uint64_t sum;
+    size_t len = serializeModel(a, data, &sum);
+    int ok = 1;
+    if (sum != a->savedSum) {
+        ok = writeFileAtomic(path, data, len);
+        if (ok) a->savedSum = sum;
+    }
+    free(data);
+    return ok;
+}
+
+int rl_load(RLAgent *a, const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return 0;
+
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0) size = ftell(fp);
+    if (size <= 0 || (unsigned long)size > RL_MODEL_READ_LIMIT || fseek(fp, 0, SEEK_SET) != 0) {
         fclose(fp);
         return 0;
     }
 
+    uint8_t *data = malloc((size_t)size);
+    RLAgent *tmp = malloc(sizeof(*tmp));   // a bad file leaves `a` untouched
+    int ok = data && tmp && fread(data, 1, (size_t)size, fp) == (size_t)size;
     fclose(fp);
-    return 1;
+
+    int ver = 0;
+    if (ok) {
+        *tmp = *a;
+        ver = parseModel(tmp, data, (size_t)size);
+        ok = (ver != 0);
+    }
+    if (ok) {
+        *a = *tmp;
+
+        // A current file is what rl_save would write now; an older version
+        // gets savedSum 0, so the next rl_save_if_changed upgrades it once
+        uint8_t *out = (ver == RL_MODEL_VERSION) ? realloc(data, RL_MODEL_MAX_BYTES) : NULL;
+        if (out) {
+            data = out;
+            serializeModel(a, data, &a->savedSum);
+        } else {
+            a->savedSum = 0;
+        }
+    }
+    free(tmp);
+    free(data);
+    return ok;
+}
+
+void rl_extract_features(char board[ROWS][COLS], char player, double f[RL_FEATURES]) {
+    extractFeatures(board, player, f);
 }
 
 double rl_value(const RLAgent *a, char board[ROWS][COLS], char player) {
+    if (a->model == RL_MODEL_NTUPLE) {
+        Bitboard bb;
+        bbFromBoard(&bb, board);
+        RLAccum acc;
+        accInit(&acc, &bb, RL_MODEL_NTUPLE);
+        return ntValue(a, acc.ntIndex[bbIndex(player)]);
+    }
+
     double f[RL_FEATURES];
     extractFeatures(board, player, f);
     return dot(a->w, f);
 }
 
-// Tactical: immediate win else immediate block
-static int immediateTactics(char board[ROWS][COLS], char me) {
-    char opp = otherPlayer(me);
-    char tmp[ROWS][COLS];
+// ---------- Batched evaluation ----------
+
+// out[i] = sum_k w[k] * x[k][i] for one block of feature columns, four
+// positions per SSE instruction (scalar where SSE is unavailable).
+static void batchDot(const float w[RL_FEATURES],
+                     const float x[RL_FEATURES][RL_BATCH_BLOCK],
+                     int n, float *out) {
+    int i = 0;
+#ifdef __SSE__
+    for (; i + 4 <= n; i += 4) {
+        __m128 acc = _mm_setzero_ps();
+        for (int k = 0; k < RL_FEATURES; k++) {
+            acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(w[k]), _mm_load_ps(&x[k][i])));
+        }
+        _mm_storeu_ps(out + i, acc);
+    }
+#endif
+    for (; i < n; i++) {
+        float acc = 0.0f;
+        for (int k = 0; k < RL_FEATURES; k++) acc += w[k] * x[k][i];
+        out[i] = acc;
+    }
+}
+
+void rl_value_batch(const RLAgent *a,
+                    char boards[][ROWS][COLS],
+                    const char *players,
+                    int count,
+                    double *out) {
+    if (a->model == RL_MODEL_NTUPLE) {
+        for (int i = 0; i < count; i++) out[i] = rl_value(a, boards[i], players[i]);
+        return;
+    }
+
+    float w[RL_FEATURES];
+    for (int k = 0; k < RL_FEATURES; k++) w[k] = (float)a->w[k];
+
+    // Structure of arrays: one row of RL_BATCH_BLOCK values per feature
+    _Alignas(16) float x[RL_FEATURES][RL_BATCH_BLOCK];
+    float v[RL_BATCH_BLOCK];
 
+    for (int start = 0; start < count; start += RL_BATCH_BLOCK) {
+        int n = (count - start < RL_BATCH_BLOCK) ? count - start : RL_BATCH_BLOCK;
+
+        for (int i = 0; i < n; i++) {
+            double f[RL_FEATURES];
+            extractFeatures(boards[start + i], players[start + i], f);
+            for (int k = 0; k < RL_FEATURES; k++) x[k][i] = (float)f[k];
+        }
+
+        batchDot(w, (const float (*)[RL_BATCH_BLOCK])x, n, v);
+        for (int i = 0; i < n; i++) out[start + i] = v[i];
+    }
+}
+
+// Tactical: immediate win else immediate block
+static int immediateTactics(const Bitboard *bb, int me) {
     // win now
     for (int c = 0; c < COLS; c++) {
-        if (!isMoveValidRL(board, c)) continue;
-        copyBoard(tmp, board);
-        {
-            int r = dropPiece(tmp, c, me);
-            if (r >= 0 && checkWin(tmp, me, r, c)) return c;
-        }
+        if (bbCanPlay(bb, c) && bbIsWinningMove(bb, c, me)) return c;
     }
 
     // block opp win now
     for (int c = 0; c < COLS; c++) {
-        if (!isMoveValidRL(board, c)) continue;
-        copyBoard(tmp, board);
-        {
-            int r = dropPiece(tmp, c, opp);
-            if (r >= 0 && checkWin(tmp, opp, r, c)) return c;
-        }
+        if (bbCanPlay(bb, c) && bbIsWinningMove(bb, c, me ^ 1)) return c;
     }
 
     return -1;
 }
 
-// Evaluate a move using learned value + (optional) 2-ply reply
-static double evalMove(const RLAgent *a,
-                       char board[ROWS][COLS],
-                       char player,
-                       int col,
-                       int searchDepth) {
-    char opp = otherPlayer(player);
+// ---------- Alpha-beta search on the learned value ----------
+
+// Immediate win score; the ply is subtracted so faster wins rank higher.
+// Learned values stay far below this (weights are clamped to +-50).
+#define RL_WIN 1e6
+
+static const int rlOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+// Triangular principal-variation table: length[p] moves starting at ply p
+// in moves[p]. Only kept when the caller wants statistics.
+typedef struct {
+    int         length[SEARCH_MAX_PV + 1];
+    signed char moves[SEARCH_MAX_PV + 1][SEARCH_MAX_PV];
+} RLPVTable;
+
+// Per-decision search state; the accumulator is updated in place.
+typedef struct {
+    const RLAgent *a;
+    RLAccum  *acc;
+    double    deadline;   // timeNow() value, 0 = no time budget
+    long long nodes;
+    long long leafEvals;
+    long long cutoffs;
+    long long firstCutoffs;
+    RLPVTable *pv;        // NULL = no PV
+    int       stopped;
+} RLSearch;
+
+// Column c improved alpha at `ply`: the PV there becomes c + the child's.
+static void updatePV(RLPVTable *pv, int ply, int c) {
+    pv->moves[ply][0] = (signed char)c;
+    memcpy(&pv->moves[ply][1], pv->moves[ply + 1], (size_t)pv->length[ply + 1]);
+    pv->length[ply] = pv->length[ply + 1] + 1;
+}
+
+// Move order for `me`: blocks of the opponent's immediate wins first, then
+// (with `sortByValue`) by their static learned value, center-first on ties.
+// Sorting costs one evaluation per child, so callers only ask for it at
+// least three plies from the leaves, where it pays for itself.
+static int orderMovesRL(RLSearch *s, int me, int sortByValue, int moves[COLS]) {
+    Bitboard *bb = &s->acc->bb;
+    uint64_t blocks = bbWinningCells(bb->pieces[me ^ 1], bbOccupied(bb)) & bbPlayableCells(bb);
 
-    char b1[ROWS][COLS];
-    copyBoard(b1, board);
-    int r1 = dropPiece(b1, col, player);
-    if (r1 < 0) return -RL_INF;
+    double keys[COLS];
+    int n = 0;
+    for (int i = 0; i < COLS; i++) {
+        int c = rlOrder[i];
+        if (!bbCanPlay(bb, c)) continue;
+
+        double key = 0.0;
+        if (blocks & (1ULL << (c * BB_HEIGHT + bb->height[c]))) {
+            key = RL_WIN;
+        } else if (sortByValue) {
+            accPlay(s->acc, c, me);
+            key = -accValue(s->a, s->acc, me ^ 1);
+            accUndo(s->acc, c, me);
+        }
+
+        int k = n++;
+        while (k > 0 && keys[k - 1] < key) {
+            moves[k] = moves[k - 1];
+            keys[k] = keys[k - 1];
+            k--;
+        }
+        moves[k] = c;
+        keys[k] = key;
+    }
+    return n;
+}
 
-    // If we win immediately, it's best
-    if (checkWin(b1, player, r1, col)) return RL_INF;
+// Negamax with alpha-beta. Scores are from `me`'s point of view: the
+// learned value at the leaves, RL_WIN - ply for a win on the spot.
+static double negamaxRL(RLSearch *s, int me, int depth, int ply, double alpha, double beta) {
+    Bitboard *bb = &s->acc->bb;
 
-    if (searchDepth <= 1) {
-        // 1-ply: prefer states that are bad for opponent-to-move
-        return -rl_value(a, b1, opp);
+    s->nodes++;
+    if ((s->nodes & 255) == 0 && s->deadline > 0.0 && timeNow() >= s->deadline) {
+        s->stopped = 1;
+    }
+    if (s->stopped) return 0.0;
+    if (s->pv) s->pv->length[ply] = 0;
+
+    if (depth == 0) {
+        s->leafEvals++;
+        return accValue(s->a, s->acc, me);
+    }
+
+    if (bbWinningCells(bb->pieces[me], bbOccupied(bb)) & bbPlayableCells(bb)) {
+        return RL_WIN - ply;
+    }
+
+    int moves[COLS];
+    int n = orderMovesRL(s, me, depth >= 3, moves);
+    if (n == 0) return 0.0;   // board full: draw
+
+    double best = -RL_INF;
+    for (int i = 0; i < n; i++) {
+        int c = moves[i];
+        accPlay(s->acc, c, me);
+        double v = -negamaxRL(s, me ^ 1, depth - 1, ply + 1, -beta, -alpha);
+        accUndo(s->acc, c, me);
+        if (s->stopped) return 0.0;
+
+        if (v > best) best = v;
+        if (v > alpha) {
+            alpha = v;
+            if (s->pv) updatePV(s->pv, ply, c);
+        }
+        if (alpha >= beta) {
+            s->cutoffs++;
+            if (i == 0) s->firstCutoffs++;
+            break;
+        }
     }
+    return best;
+}
 
-    // 2-ply: opponent picks reply that minimizes our outcome
-    double worst = RL_INF;
-    int any = 0;
+// Search every root move to `depth`; `first` (if playable) is tried first.
+// Returns the best column, ties going to the earlier move, and its score
+// in `scoreOut`.
+static int searchRootRL(RLSearch *s, int me, int depth, int first, double *scoreOut) {
+    if (s->pv) s->pv->length[0] = 0;
 
-    for (int oc = 0; oc < COLS; oc++) {
-        if (!isMoveValidRL(b1, oc)) continue;
-        any = 1;
+    int moves[COLS];
+    int n = orderMovesRL(s, me, depth >= 3, moves);
 
-        char b2[ROWS][COLS];
-        copyBoard(b2, b1);
-        int r2 = dropPiece(b2, oc, opp);
-        if (r2 >= 0 && checkWin(b2, opp, r2, oc)) {
-            // opponent has winning reply => terrible line
-            worst = -RL_INF;
+    for (int i = 1; i < n; i++) {
+        if (moves[i] == first) {
+            memmove(moves + 1, moves, sizeof(int) * (size_t)i);
+            moves[0] = first;
             break;
         }
+    }
 
-        // after opponent move, it's our turn again
-        {
-            double v = rl_value(a, b2, player);
-            if (v < worst) worst = v;
+    int bestC = (n > 0) ? moves[0] : 0;
+    double bestScore = -RL_INF;
+    for (int i = 0; i < n; i++) {
+        int c = moves[i];
+        accPlay(s->acc, c, me);
+        // Only a strictly better score matters, so search with alpha = best
+        double v = -negamaxRL(s, me ^ 1, depth - 1, 1, -RL_INF, -bestScore);
+        accUndo(s->acc, c, me);
+        if (s->stopped) break;
+
+        if (v > bestScore) {
+            bestScore = v;
+            bestC = c;
+            if (s->pv) updatePV(s->pv, 0, c);
         }
     }
+    *scoreOut = bestScore;
+    return bestC;
+}
 
-    if (!any) return 0.0;
-    return worst;
+// Record a move that was not searched (tactic, exploration or book).
+static int unsearchedMove(SearchStats *stats, const char *source, int move) {
+    if (stats) {
+        stats->source = source;
+        stats->move = move;
+        stats->pv[0] = (signed char)move;
+        stats->pvLength = 1;
+    }
+    return move;
 }
 
-int rl_choose_move(const RLAgent *a,
-                   char board[ROWS][COLS],
-                   char player,
-                   double epsilon_override,
-                   int searchDepth) {
-    int t = immediateTactics(board, player);
-    if (t != -1) return t;
+// The PV of a finished root iteration goes to the statistics.
+static void keepPV(const RLSearch *s, SearchStats *stats) {
+    if (!s->pv) return;
+    stats->pvLength = s->pv->length[0];
+    memcpy(stats->pv, s->pv->moves[0], (size_t)stats->pvLength);
+}
+
+// Move choice on an accumulator (left unchanged on return), searching
+// `searchDepth` plies or deepening within `moveTimeMs`. Search statistics
+// and the PV go to `stats` when it is not NULL.
+static int chooseMoveAcc(const RLAgent *a,
+                         RLAccum *acc,
+                         int me,
+                         double epsilon_override,
+                         int searchDepth,
+                         int moveTimeMs,
+                         const Book *book,
+                         RLRng *rng,
+                         SearchStats *stats) {
+    const Bitboard *bb = &acc->bb;
+    if (stats) searchStatsReset(stats, "rl", bb->moves);
+
+    int t = immediateTactics(bb, me);
+    if (t != -1) return unsearchedMove(stats, "tactic", t);
 
     double eps = (epsilon_override < 0.0) ? a->epsilon : epsilon_override;
 
     int valid[COLS];
     int vc = 0;
     for (int c = 0; c < COLS; c++) {
-        if (isMoveValidRL(board, c)) valid[vc++] = c;
+        if (bbCanPlay(bb, c)) valid[vc++] = c;
     }
     if (vc == 0) return 0;
 
-    if (((double)rand() / (double)RAND_MAX) < eps) {
-        return valid[rand() % vc];
+    if (randUniform(rng) < eps) {
+        return unsearchedMove(stats, "random", valid[randIndex(rng, vc)]);
     }
 
-    int bestC = valid[0];
-    double bestScore = -RL_INF;
-
-    // Center-first ordering helps (not required, but good)
-    static const int order[COLS] = {3,2,4,1,5,0,6};
-
-    for (int i = 0; i < COLS; i++) {
-        int c = order[i];
-        if (!isMoveValidRL(board, c)) continue;
+    // Greedy play only: self-play training keeps learning its own openings.
+    if (book && eps <= 0.0) {
+        int move = bookBestMove(book, bb, me, NULL);
+        if (move >= 0) return unsearchedMove(stats, "book", move);
+    }
 
-        double s = evalMove(a, board, player, c, searchDepth);
-        if (s > bestScore) {
-            bestScore = s;
+    RLPVTable pv;
+    RLSearch search;
+    memset(&search, 0, sizeof(search));
+    search.a = a;
+    search.acc = acc;
+    search.pv = stats ? &pv : NULL;
+    double start = stats ? timeNow() : 0.0;
+
+    if (searchDepth < 1) searchDepth = 1;
+    int maxDepth = ROWS * COLS - bb->moves;
+    int bestC;
+    double bestScore;
+    int completed;
+    if (moveTimeMs <= 0) {
+        bestC = searchRootRL(&search, me, searchDepth, -1, &bestScore);
+        completed = (searchDepth < maxDepth) ? searchDepth : maxDepth;
+        if (stats) keepPV(&search, stats);
+    } else {
+        // Iterative deepening up to searchDepth; keep the deepest finished
+        // iteration. Depth 1 always completes.
+        bestC = searchRootRL(&search, me, 1, -1, &bestScore);
+        completed = 1;
+        if (stats) keepPV(&search, stats);
+        search.deadline = timeNow() + moveTimeMs / 1000.0;
+        for (int depth = 2; depth <= searchDepth && depth <= maxDepth; depth++) {
+            double score;
+            int c = searchRootRL(&search, me, depth, bestC, &score);
+            if (search.stopped) break;
             bestC = c;
+            bestScore = score;
+            completed = depth;
+            if (stats) keepPV(&search, stats);
         }
     }
 
+    if (stats) {
+        stats->move = bestC;
+        stats->score = bestScore;
+        stats->depth = completed;
+        stats->nodes = search.nodes;
+        stats->leafEvals = search.leafEvals;
+        stats->cutoffs = search.cutoffs;
+        stats->firstCutoffs = search.firstCutoffs;
+        stats->ms = (timeNow() - start) * 1000.0;
+    }
     return bestC;
 }
 
-// TD(lambda) weight update
+int rl_choose_move(const RLAgent *a,
+                   C4Engine *e,
+                   char board[ROWS][COLS],
+                   char player,
+                   double epsilon_override) {
+    Bitboard bb;
+    bbFromBoard(&bb, board);
+    RLAccum acc;
+    accInit(&acc, &bb, a->model);
+    return chooseMoveAcc(a, &acc, bbIndex(player), epsilon_override, e->depth,
+                         e->moveTimeMs, e->book, &e->rng, &e->stats);
+}
+
+// Eligibility traces of one episode. The linear model keeps one trace per
+// weight; the N-tuple model remembers the table entries of every state so
+// far and replays them with a decaying step (equivalent to accumulating
+// traces, without touching the whole table each move).
+typedef struct {
+    double   e[RL_FEATURES];
+    int      steps;
+    uint16_t visited[ROWS * COLS][RL_NT_TUPLES];
+} RLTrace;
+
+// TD(lambda) update for the state whose features / tuple entries were
+// recorded last
 static void td_lambda_update(RLAgent *a,
-                             double e[RL_FEATURES],
+                             RLTrace *tr,
                              const double f_s[RL_FEATURES],
                              double delta) {
+    if (a->model == RL_MODEL_NTUPLE) {
+        double trace = 1.0;
+        for (int k = tr->steps - 1; k >= 0 && trace >= RL_NT_TRACE_MIN; k--) {
+            float step = (float)(a->ntAlpha * delta * trace);
+            for (int t = 0; t < RL_NT_TUPLES; t++) a->nt[tr->visited[k][t]] += step;
+            trace *= a->gamma * a->lambda;
+        }
+        return;
+    }
+
     for (int i = 0; i < RL_FEATURES; i++) {
-        e[i] = a->gamma * a->lambda * e[i] + f_s[i];
-        a->w[i] += a->alpha * delta * e[i];
+        tr->e[i] = a->gamma * a->lambda * tr->e[i] + f_s[i];
+        a->w[i] += a->alpha * delta * tr->e[i];
     }
     clampWeights(a);
 }
 
-void rl_train_selfplay(RLAgent *a, int games) {
+// Online TD(lambda) step: `current` plays `col` in the accumulator's
+// position. Returns the GAMELOG_* result when the move ends the game,
+// -1 otherwise.
+static int learnMove(RLAgent *a, RLAccum *acc, RLTrace *trace, int current, int col) {
+    // State features/value (player-to-move = current)
+    double f_s[RL_FEATURES];
+    double v_s;
+    if (acc->nt) {
+        memcpy(trace->visited[trace->steps++], acc->ntIndex[current], sizeof(acc->ntIndex[current]));
+        v_s = ntValue(a, acc->ntIndex[current]);
+    } else {
+        accFeatures(acc, current, f_s);
+        v_s = dot(a->w, f_s);
+    }
+
+    int won = bbIsWinningMove(&acc->bb, col, current);
+    accPlay(acc, col, current);
+
+    // Terminal win
+    if (won) {
+        double reward = 1.0;
+        double delta = reward - v_s; // terminal: no bootstrap
+        td_lambda_update(a, trace, f_s, delta);
+        return (current == 0) ? GAMELOG_X_WON : GAMELOG_O_WON;
+    }
+
+    // Draw
+    if (bbIsFull(&acc->bb)) {
+        double reward = 0.0;
+        double delta = reward - v_s;
+        td_lambda_update(a, trace, f_s, delta);
+        return GAMELOG_DRAW;
+    }
+
+    // Non-terminal: reward shaping (teaches tactics strongly)
+    int opp = current ^ 1;
+
+    int oppWinsNext = bbCountWinningMoves(&acc->bb, opp);
+    int myWinsNext  = bbCountWinningMoves(&acc->bb, current);
+
+    double reward = 0.0;
+
+    // Big penalty if we allow opponent an immediate win next turn
+    if (oppWinsNext > 0) reward -= 0.9;
+
+    // Small bonus if we create an immediate win threat
+    if (myWinsNext > 0) reward += 0.2;
+
+    // Bootstrap from next state's value (opponent-to-move)
+    double v_next = accValue(a, acc, opp);
+
+    // From current's perspective, opponent value is negated
+    double target = reward + a->gamma * (-v_next);
+
+    double delta = target - v_s;
+    td_lambda_update(a, trace, f_s, delta);
+    return -1;
+}
+
+static void episodeInit(const RLAgent *a, RLAccum *acc, RLTrace *trace) {
+    Bitboard empty;
+    bbInit(&empty);
+    accInit(acc, &empty, a->model);
+
+    // Eligibility traces per episode
+    for (int i = 0; i < RL_FEATURES; i++) trace->e[i] = 0.0;
+    trace->steps = 0;
+}
+
+// One self-play episode with online TD(lambda) updates to `a`. The
+// features of each state come from one accumulator kept for the game;
+// the moves are recorded in `rec`.
+static void playTrainingGame(RLAgent *a, double eps, RLRng *rng, GameRecord *rec) {
+    RLAccum acc;
+    RLTrace trace;
+    episodeInit(a, &acc, &trace);
+
+    int current = (int)(rl_rng_next(rng) & 1);
+    rec->first = current;
+    rec->moves = 0;
+
+    while (1) {
+        // Choose move: depth 1 is fast enough for training
+        int col = chooseMoveAcc(a, &acc, current, eps, 1, 0, NULL, rng, NULL);
+        rec->cols[rec->moves++] = (int8_t)col;
+
+        rec->result = learnMove(a, &acc, &trace, current, col);
+        if (rec->result >= 0) break;
+        current ^= 1;
+    }
+}
+
+// The same TD(lambda) updates along a logged game. Stops at the first
+// illegal move of a damaged record.
+static void replayTrainingGame(RLAgent *a, const GameRecord *rec) {
+    RLAccum acc;
+    RLTrace trace;
+    episodeInit(a, &acc, &trace);
+
+    int current = rec->first;
+    for (int i = 0; i < rec->moves; i++) {
+        int col = rec->cols[i];
+        if (!bbCanPlay(&acc.bb, col)) break;
+        if (learnMove(a, &acc, &trace, current, col) >= 0) break;
+        current ^= 1;
+    }
+}
+
+// One training thread: plays (or replays) its share of a round on a
+// private copy of the weights, so workers never write shared state.
+typedef struct {
+    RLAgent local;
+    RLRng   rng;
+    int     firstGame;    // global index of this worker's first game
+    int     count;        // games this round
+    int     totalGames;
+    double  epsStart;
+
+    const GameLog *replay;   // replay these games instead of playing
+    int      logging;        // pack played games into logBuf
+    size_t   logLen;
+    uint8_t  logBuf[RL_TRAIN_BATCH * GAMELOG_MAX_RECORD];
+} TrainWorker;
+
+static void *trainWorkerMain(void *arg) {
     // Epsilon schedule (decays to low exploration)
-    const double eps_start = a->epsilon;
-    const double eps_end   = 0.02;
-
-    for (int g = 0; g < games; g++) {
-        char board[ROWS][COLS];
-        initializeBoard(board);
-
-        // Eligibility traces per episode
-        double e[RL_FEATURES];
-        for (int i = 0; i < RL_FEATURES; i++) e[i] = 0.0;
-
-        // Linear decay of epsilon
-        double frac = (games <= 1) ? 1.0 : (double)g / (double)(games - 1);
-        double eps = eps_start + (eps_end - eps_start) * frac;
-
-        char current = (rand() & 1) ? PLAYER1 : PLAYER2;
-
-        while (1) {
-            // State features/value (player-to-move = current)
-            double f_s[RL_FEATURES];
-            extractFeatures(board, current, f_s);
-            double v_s = dot(a->w, f_s);
-
-            // Choose move: depth 1 is fast enough for training
-            int col = rl_choose_move(a, board, current, eps, 1);
-            int row = dropPiece(board, col, current);
-
-            // Terminal win
-            if (row >= 0 && checkWin(board, current, row, col)) {
-                double reward = 1.0;
-                double delta = reward - v_s; // terminal: no bootstrap
-                td_lambda_update(a, e, f_s, delta);
-                break;
-            }
+    const double eps_end = 0.02;
+    TrainWorker *w = arg;
+    GameRecord rec;
+
+    w->logLen = 0;
+    for (int g = w->firstGame; g < w->firstGame + w->count; g++) {
+        if (w->replay) {
+            if (gameLogRead(w->replay, (uint64_t)g, &rec)) replayTrainingGame(&w->local, &rec);
+            continue;
+        }
 
-            // Draw
-            if (isBoardFull(board)) {
-                double reward = 0.0;
-                double delta = reward - v_s;
-                td_lambda_update(a, e, f_s, delta);
-                break;
-            }
+        // Linear decay of epsilon over the whole run
+        double frac = (w->totalGames <= 1) ? 1.0 : (double)g / (double)(w->totalGames - 1);
+        double eps = w->epsStart + (eps_end - w->epsStart) * frac;
+        playTrainingGame(&w->local, eps, &w->rng, &rec);
+        if (w->logging) w->logLen += gameLogPack(&rec, w->logBuf + w->logLen);
+    }
+    return NULL;
+}
+
+// ---------- Checkpoints ----------
+
+void rl_set_checkpoint(RLAgent *a, const char *path, int seconds) {
+    a->checkpointPath = path;
+    a->checkpointSecs = (path && seconds > 0) ? seconds : 0;
+}
+
+// Background writer. Between rounds the training thread hands over a
+// snapshot and carries on; while the previous one is still being written,
+// new snapshots are skipped.
+typedef struct {
+    pthread_t       thread;
+    pthread_mutex_t lock;
+    pthread_cond_t  wake;
+    RLAgent        *snapshot;
+    const char     *path;
+    int             pending;   // snapshot waiting or being written
+    int             quit;
+} Checkpointer;
+
+static void *checkpointMain(void *arg) {
+    Checkpointer *cp = arg;
+    pthread_mutex_lock(&cp->lock);
+    while (1) {
+        while (!cp->pending && !cp->quit) pthread_cond_wait(&cp->wake, &cp->lock);
+        if (!cp->pending) break;   // quitting, nothing left to write
+
+        pthread_mutex_unlock(&cp->lock);
+        rl_save(cp->snapshot, cp->path);
+        pthread_mutex_lock(&cp->lock);
+        cp->pending = 0;
+    }
+    pthread_mutex_unlock(&cp->lock);
+    return NULL;
+}
+
+static int checkpointStart(Checkpointer *cp, const RLAgent *a) {
+    if (a->checkpointSecs <= 0) return 0;
+
+    cp->snapshot = malloc(sizeof(RLAgent));
+    if (!cp->snapshot) return 0;
+    cp->path = a->checkpointPath;
+    cp->pending = 0;
+    cp->quit = 0;
+    pthread_mutex_init(&cp->lock, NULL);
+    pthread_cond_init(&cp->wake, NULL);
+    if (pthread_create(&cp->thread, NULL, checkpointMain, cp) != 0) {
+        pthread_cond_destroy(&cp->wake);
+        pthread_mutex_destroy(&cp->lock);
+        free(cp->snapshot);
+        return 0;
+    }
+    return 1;
+}
 
-            // Non-terminal: reward shaping (teaches tactics strongly)
-            {
-                char opp = otherPlayer(current);
+static void checkpointPost(Checkpointer *cp, const RLAgent *a) {
+    pthread_mutex_lock(&cp->lock);
+    if (!cp->pending) {
+        *cp->snapshot = *a;
+        cp->pending = 1;
+        pthread_cond_signal(&cp->wake);
+    }
+    pthread_mutex_unlock(&cp->lock);
+}
 
-                int oppWinsNext = countImmediateWins(board, opp);
-                int myWinsNext  = countImmediateWins(board, current);
+// Finish the snapshot in flight, if any, and stop the writer.
+static void checkpointStop(Checkpointer *cp) {
+    pthread_mutex_lock(&cp->lock);
+    cp->quit = 1;
+    pthread_cond_signal(&cp->wake);
+    pthread_mutex_unlock(&cp->lock);
+    pthread_join(cp->thread, NULL);
+    pthread_cond_destroy(&cp->wake);
+    pthread_mutex_destroy(&cp->lock);
+    free(cp->snapshot);
+}
 
-                double reward = 0.0;
+// ---------- Training rounds ----------
 
-                // Big penalty if we allow opponent an immediate win next turn
-                if (oppWinsNext > 0) reward -= 0.9;
+// Play or replay the rest of `run`, shared by self-play and log replay.
+// Self-play keeps its progress in a->run, so checkpoints taken between
+// rounds can resume it.
+static void runTraining(RLAgent *a, RLTrainRun *run, const GameLog *replay) {
+    int threads = run->threads;
 
-                // Small bonus if we create an immediate win threat
-                if (myWinsNext > 0) reward += 0.2;
+    // Workers carry a full copy of the model (N-tuple tables included), so
+    // they live on the heap.
+    TrainWorker *workers = malloc(sizeof(TrainWorker) * (size_t)threads);
+    if (!workers) return;
 
-                // Bootstrap from next state's value (opponent-to-move)
-                double v_next = rl_value(a, board, opp);
+    for (int t = 0; t < threads; t++) {
+        workers[t].rng = run->rng[t];
+        workers[t].replay = replay;
+        workers[t].logging = (a->gameLog != NULL && replay == NULL);
+    }
 
-                // From current's perspective, opponent value is negated
-                double target = reward + a->gamma * (-v_next);
+    Checkpointer cp;
+    int checkpointing = (replay == NULL) && checkpointStart(&cp, a);
+    double lastCheckpoint = timeNow();
+
+    // Rounds of RL_TRAIN_BATCH games per worker. Every worker starts the
+    // round from the same weights; afterwards their weight changes are
+    // summed in worker order, so the result only depends on the seed and
+    // the thread count, not on scheduling.
+    while (run->done < run->games) {
+        int games = run->games;
+        int next = run->done;
+        int used = 0;
+        for (int t = 0; t < threads && next < games; t++) {
+            TrainWorker *w = &workers[t];
+            w->local = *a;
+            w->firstGame = next;
+            w->count = (games - next < RL_TRAIN_BATCH) ? games - next : RL_TRAIN_BATCH;
+            w->totalGames = games;
+            w->epsStart = run->epsStart;
+            next += w->count;
+            used++;
+        }
 
-                double delta = target - v_s;
-                td_lambda_update(a, e, f_s, delta);
+        pthread_t tids[RL_MAX_THREADS];
+        int spawned[RL_MAX_THREADS] = {0};
+        for (int t = 1; t < used; t++) {
+            spawned[t] = (pthread_create(&tids[t], NULL, trainWorkerMain, &workers[t]) == 0);
+        }
+        trainWorkerMain(&workers[0]);
+        for (int t = 1; t < used; t++) {
+            if (spawned[t]) pthread_join(tids[t], NULL);
+            else            trainWorkerMain(&workers[t]);   // no thread: run it here
+        }
 
-                current = opp;
+        // Stream the round's games in worker order (= game order)
+        for (int t = 0; t < used; t++) {
+            if (workers[t].logging) {
+                gameLogWrite(a->gameLog, workers[t].logBuf, workers[t].logLen, workers[t].count);
             }
         }
+
+        if (used == 1) {
+            // Sequential training: plain online TD(lambda)
+            memcpy(a->w, workers[0].local.w, sizeof(a->w));
+            memcpy(a->nt, workers[0].local.nt, sizeof(a->nt));
+        } else {
+            double base[RL_FEATURES];
+            memcpy(base, a->w, sizeof(base));
+            for (int t = 0; t < used; t++) {
+                for (int i = 0; i < RL_FEATURES; i++) {
+                    a->w[i] += workers[t].local.w[i] - base[i];
+                }
+            }
+            clampWeights(a);
+
+            if (a->model == RL_MODEL_NTUPLE) {
+                // Worker 0's tables already hold the base plus its own change
+                float *nt = workers[0].local.nt;
+                for (int t = 1; t < used; t++) {
+                    for (int i = 0; i < RL_NT_WEIGHTS; i++) nt[i] += workers[t].local.nt[i] - a->nt[i];
+                }
+                memcpy(a->nt, nt, sizeof(a->nt));
+            }
+        }
+
+        if (!replay) a->gamesTrained += (uint64_t)(next - run->done);
+        for (int t = 0; t < used; t++) run->rng[t] = workers[t].rng;
+        run->done = next;
+
+        if (checkpointing && run->done < run->games &&
+            timeNow() - lastCheckpoint >= a->checkpointSecs) {
+            checkpointPost(&cp, a);
+            lastCheckpoint = timeNow();
+        }
+    }
+
+    if (checkpointing) checkpointStop(&cp);
+    free(workers);
+}
+
+void rl_train_selfplay_mt(RLAgent *a, int games, int threads, uint64_t seed) {
+    if (threads < 1) threads = 1;
+    if (threads > RL_MAX_THREADS) threads = RL_MAX_THREADS;
+
+    RLTrainRun *run = &a->run;
+    memset(run, 0, sizeof(*run));
+    run->games = games;
+    run->threads = threads;
+    run->epsStart = a->epsilon;
+    for (int t = 0; t < threads; t++) {
+        rl_rng_seed(&run->rng[t], seed + (uint64_t)t * 0x9E3779B97F4A7C15ULL);
     }
+
+    runTraining(a, run, NULL);
+    memset(run, 0, sizeof(*run));
+}
+
+int rl_train_resume(RLAgent *a) {
+    RLTrainRun *run = &a->run;
+    if (run->games <= 0 || run->done >= run->games) {
+        memset(run, 0, sizeof(*run));
+        return 0;
+    }
+
+    runTraining(a, run, NULL);
+    memset(run, 0, sizeof(*run));
+    return 1;
+}
+
+void rl_train_from_log(RLAgent *a, const GameLog *log, int epochs, int threads) {
+    if (threads < 1) threads = 1;
+    if (threads > RL_MAX_THREADS) threads = RL_MAX_THREADS;
+
+    for (int e = 0; e < epochs; e++) {
+        RLTrainRun run;
+        memset(&run, 0, sizeof(run));
+        run.games = (log->count > (uint64_t)INT_MAX) ? INT_MAX : (int)log->count;
+        run.threads = threads;
+        runTraining(a, &run, log);
+    }
+}
+
+void rl_train_selfplay(RLAgent *a, int games) {
+    rl_train_selfplay_mt(a, games, 1, a->gamesTrained + 1);
 }
@@ -1,34 +1,137 @@
 #ifndef RL_AGENT_H
 #define RL_AGENT_H
 
+#include <stdint.h>
 #include "connect_four.h"
+#include "windows.h"
 
 #define RL_FEATURES 14
+#define RL_MAX_THREADS 64
+
+// Value models
+enum {
+    RL_MODEL_LINEAR,   // 14 hand-crafted features, weights w[]
+    RL_MODEL_NTUPLE    // N-tuple network, lookup tables nt[]
+};
+
+// N-tuple network: every 4-cell line plus every 2x3 block of cells. Each
+// tuple has its own lookup table with one entry per pattern of its cells
+// (empty / side to move / other side), all tables back to back in nt[].
+#define RL_NT_LINES   NUM_WINDOWS
+#define RL_NT_BLOCKS  ((ROWS - 1) * (COLS - 2))
+#define RL_NT_TUPLES  (RL_NT_LINES + RL_NT_BLOCKS)
+#define RL_NT_WEIGHTS (RL_NT_LINES * 81 + RL_NT_BLOCKS * 729)
+
+// Small per-thread random generator (xorshift64*) for training
+typedef struct {
+    uint64_t state;
+} RLRng;
+
+// A self-play run in progress, saved with the model so that an
+// interrupted run resumes exactly where its last checkpoint was taken.
+typedef struct {
+    int      games;      // games in the run, 0 = no run in progress
+    int      done;       // games finished (always whole rounds)
+    int      threads;
+    double   epsStart;
+    RLRng    rng[RL_MAX_THREADS];   // worker generators after `done` games
+} RLTrainRun;
+
+struct GameLogWriter;
 
 typedef struct {
+    int    model;    // RL_MODEL_*
     double w[RL_FEATURES];
+    float  nt[RL_NT_WEIGHTS];
 
     // Learning hyperparameters
-    double alpha;    // learning rate
+    double alpha;    // learning rate (linear weights)
+    double ntAlpha;  // learning rate per N-tuple table entry
     double gamma;    // discount factor
     double lambda;   // eligibility trace decay (TD(lambda))
     double epsilon;  // starting exploration (training)
+
+    // Training progress
+    uint64_t   gamesTrained;   // self-play games learned from, over all runs
+    RLTrainRun run;
+
+    uint64_t savedSum;   // checksum of the file last loaded / saved, 0 = none
+
+    // Self-play outputs (not saved; reset by rl_init)
+    struct GameLogWriter *gameLog;     // rl_set_game_log
+    const char           *checkpointPath;
+    int                   checkpointSecs;
 } RLAgent;
 
-void  rl_init(RLAgent *a);
+void     rl_rng_seed(RLRng *r, uint64_t seed);
+uint32_t rl_rng_next(RLRng *r);
+double   rl_rng_uniform(RLRng *r);   // [0, 1)
+
+void  rl_init(RLAgent *a);           // linear model
+void  rl_init_ntuple(RLAgent *a);    // N-tuple model, empty tables
 int   rl_load(RLAgent *a, const char *path);
+
+// Write to a temporary file next to `path`, then rename it over `path`,
+// so a crash never leaves a half-written model behind.
 int   rl_save(const RLAgent *a, const char *path);
 
+// rl_save, skipped (returning 1) when the model is byte for byte what was
+// last loaded from or saved to a file.
+int   rl_save_if_changed(RLAgent *a, const char *path);
+
+// The linear model's feature vector for `player` to move
+void rl_extract_features(char board[ROWS][COLS], char player, double f[RL_FEATURES]);
+
 // Value from perspective of "player to move" (player = 'X' or 'O')
 double rl_value(const RLAgent *a, char board[ROWS][COLS], char player);
 
-// Choose move for `player`.
+// rl_value for `count` boards at once (players[i] to move on boards[i]).
+// Features go into a structure-of-arrays buffer and the dot products run
+// in float32 SIMD, so results match rl_value to float precision; rl_value
+// stays the double-precision reference. N-tuple models are scored one
+// position at a time.
+void rl_value_batch(const RLAgent *a,
+                    char boards[][ROWS][COLS],
+                    const char *players,
+                    int count,
+                    double *out);
+
+// Choose move for `player` with an alpha-beta search over the learned
+// value, using the engine context `e` (engine.h) for everything but the
+// model: e->depth plies (1 = greedy on the value after our move), or
+// iterative deepening up to it within e->moveTimeMs; e->book when not
+// exploring; e->rng for exploration. Statistics and PV go to e->stats.
+struct C4Engine;
 int rl_choose_move(const RLAgent *a,
+                   struct C4Engine *e,
                    char board[ROWS][COLS],
                    char player,
-                   double epsilon_override,
-                   int searchDepth);
+                   double epsilon_override);
 
-// Train by self-play
+// Stream every self-play training game of `a` to `log` (NULL = off)
+void rl_set_game_log(RLAgent *a, struct GameLogWriter *log);
+
+// Train by self-play (seeded from the games trained so far)
 void rl_train_selfplay(RLAgent *a, int games);
+
+// Self-play on `threads` workers. Each round every worker plays a batch of
+// games on its own copy of the weights; the changes are then summed into
+// `a`. Results are reproducible for a given seed and thread count.
+void rl_train_selfplay_mt(RLAgent *a, int games, int threads, uint64_t seed);
+
+// Finish a self-play run that was interrupted after a checkpoint (its
+// state is in a->run). Gives the same model as the uninterrupted run.
+// Returns 0 if there is nothing to resume.
+int  rl_train_resume(RLAgent *a);
+
+// While self-play of `a` runs, save the model to `path` every `seconds`
+// from a background thread (NULL / 0 = off). Snapshots are taken between
+// rounds. Set after rl_init.
+void rl_set_checkpoint(RLAgent *a, const char *path, int seconds);
+
+// Offline training: replay every game of a mapped experience log `epochs`
+// times with the same TD(lambda) updates as self-play, on `threads`
+// workers merged the same way. No games are generated.
+struct GameLog;
+void rl_train_from_log(RLAgent *a, const struct GameLog *log, int epochs, int threads);
 #endif
\ No newline at end of file
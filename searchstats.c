@@ -0,0 +1,65 @@
+#include <math.h>
+#include <string.h>
+#include "searchstats.h"
+
+void searchStatsReset(SearchStats *st, const char *engine, int ply) {
+    memset(st, 0, sizeof(*st));
+    st->engine = engine;
+    st->source = "search";
+    st->ply = ply;
+    st->threads = 1;
+}
+
+double searchStatsFirstCutRate(const SearchStats *st) {
+    return (st->cutoffs > 0) ? (double)st->firstCutoffs / (double)st->cutoffs : 0.0;
+}
+
+double searchStatsEBF(const SearchStats *st) {
+    if (st->depth < 1 || st->nodes < 1) return 0.0;
+    return pow((double)st->nodes, 1.0 / st->depth);
+}
+
+// ---------- Console ----------
+
+void searchStatsPrint(const SearchStats *st, FILE *out) {
+    if (strcmp(st->source, "search") != 0) {
+        fprintf(out, "Stats: %s %s move\n", st->engine, st->source);
+        return;
+    }
+
+    double nps = (st->ms > 0.0) ? st->nodes / (st->ms / 1000.0) : 0.0;
+    fprintf(out, "Stats: %s depth %d, score %g, %lld nodes, %.1f ms, %.0f nodes/s, %d thread%s\n",
+            st->engine, st->depth, st->score, st->nodes, st->ms, nps,
+            st->threads, st->threads == 1 ? "" : "s");
+
+    fprintf(out, "       %lld leaf evals, %lld cutoffs (%.1f%% first move), EBF %.2f",
+            st->leafEvals, st->cutoffs, 100.0 * searchStatsFirstCutRate(st), searchStatsEBF(st));
+    if (st->ttProbes > 0) {
+        fprintf(out, ", TT %.1f%% of %lld probes",
+                100.0 * (double)st->ttHits / (double)st->ttProbes, st->ttProbes);
+    }
+    fputc('\n', out);
+
+    if (st->pvLength > 0) {
+        fprintf(out, "       PV:");
+        for (int i = 0; i < st->pvLength; i++) fprintf(out, " %d", st->pv[i] + 1);
+        fputc('\n', out);
+    }
+}
+
+// ---------- JSON ----------
+
+void searchStatsWriteJSON(const SearchStats *st, FILE *out) {
+    fprintf(out, "{\"engine\":\"%s\",\"source\":\"%s\",\"ply\":%d,\"move\":%d,"
+                 "\"score\":%g,\"depth\":%d,\"nodes\":%lld,\"leaf_evals\":%lld,"
+                 "\"cutoffs\":%lld,\"first_cutoff_rate\":%.4f,\"ebf\":%.3f,"
+                 "\"tt_probes\":%lld,\"tt_hits\":%lld,\"threads\":%d,\"ms\":%.3f,\"pv\":[",
+            st->engine, st->source, st->ply, st->move + 1,
+            st->score, st->depth, st->nodes, st->leafEvals,
+            st->cutoffs, searchStatsFirstCutRate(st), searchStatsEBF(st),
+            st->ttProbes, st->ttHits, st->threads, st->ms);
+    for (int i = 0; i < st->pvLength; i++) {
+        fprintf(out, "%s%d", i ? "," : "", st->pv[i] + 1);
+    }
+    fputs("]}\n", out);
+}
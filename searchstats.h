@@ -0,0 +1,53 @@
+#ifndef SEARCHSTATS_H
+#define SEARCHSTATS_H
+
+#include <stdio.h>
+#include "connect_four.h"
+
+// =======================================================
+// Per-move search statistics of the CPU engines
+// =======================================================
+//
+// Filled into C4Engine.stats by getCPUMove (minimax, solver, book) and
+// rl_choose_move (self-learning AI) for the last move chosen.
+// Counters an engine does not have stay 0 (e.g. the RL search has no
+// transposition table). Both printers number columns 1-7.
+
+#define SEARCH_MAX_PV (ROWS * COLS)
+
+typedef struct SearchStats {
+    const char *engine;       // "minimax", "solver" or "rl"
+    const char *source;       // "search", "book", "tactic" or "random"
+    int         ply;          // stones on the board before the move
+    int         move;         // column played, 0..COLS-1
+    double      score;        // engine's own scale, from the mover's side
+    int         depth;        // deepest finished iteration
+
+    long long   nodes;
+    long long   leafEvals;    // static evaluations at the horizon
+    long long   cutoffs;      // beta cutoffs in the move loops
+    long long   firstCutoffs; // ... of which by the first move searched
+    long long   ttProbes;
+    long long   ttHits;
+    int         threads;
+    double      ms;
+
+    int         pvLength;
+    signed char pv[SEARCH_MAX_PV];  // principal variation, starting with move
+} SearchStats;
+
+void   searchStatsReset(SearchStats *st, const char *engine, int ply);
+
+// Share of cutoffs made by the first move (0 without cutoffs)
+double searchStatsFirstCutRate(const SearchStats *st);
+
+// Effective branching factor, nodes^(1/depth) (0 below depth 1)
+double searchStatsEBF(const SearchStats *st);
+
+// Two or three human-readable lines for the console game
+void   searchStatsPrint(const SearchStats *st, FILE *out);
+
+// One JSON object and a newline, for log pipelines
+void   searchStatsWriteJSON(const SearchStats *st, FILE *out);
+
+#endif
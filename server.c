@@ -0,0 +1,932 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+#include "connect_four.h"
+#include "engine.h"
+#include "rl_agent.h"
+#include "book.h"
+#include "timeutil.h"
+
+// =======================================================
+// Multi-game server (c4_server)
+// =======================================================
+//
+// Hosts one game per connection on a TCP or UNIX socket. A single I/O
+// thread multiplexes every connection with epoll; engine moves are queued
+// to a pool of search workers, each with its own engine context, and their
+// results come back through an eventfd. A slow search therefore only
+// delays its own game.
+//
+// Line protocol (one reply line per request, columns 1-7, the client's
+// results are win/loss/draw):
+//   new [ENGINE] [first|second]   -> ok            (client moves first)
+//                                 -> reply C       (engine opened in C)
+//   move C                        -> reply C [RESULT] | end RESULT
+//   board                         -> board ROW/ROW/.../ROW TO_MOVE
+//   quit                          -> bye
+//   anything invalid              -> err MESSAGE
+// Engines: minimax:D, solver, rl[:K] (with --rl-model). Rows are sent top
+// row first; TO_MOVE is X, O or '-' once the game is over. A connection
+// reads no further requests while its engine is thinking, so pipelined
+// requests are answered in order.
+
+#ifdef __linux__
+
+#define SERVER_LINE_MAX    256
+#define SERVER_OUT_MAX     (64 * 1024)   // stop reading above this backlog
+#define SERVER_MAX_WORKERS 64
+#define SERVER_EVENTS      256
+
+enum { GAME_MINIMAX, GAME_SOLVER, GAME_RL };
+
+typedef struct Conn Conn;
+
+// The engine move a connection is waiting for. Owned by the worker
+// between queueing and completion.
+typedef struct Job {
+    Conn       *conn;
+    char        board[ROWS][COLS];
+    char        piece;
+    int         kind;
+    int         depth;
+    int         move;      // result, -1 if the engine failed
+    double      ms;
+    struct Job *next;
+} Job;
+
+struct Conn {
+    int    fd;             // -1 once closed
+    unsigned int events;   // registered with epoll
+    int    busy;           // job queued or running
+    int    closeAfterWrite;
+
+    char   in[SERVER_LINE_MAX];
+    size_t inLen;
+    char  *out;
+    size_t outLen;
+    size_t outCap;
+
+    // Game
+    int    active;
+    int    over;
+    int    kind;
+    int    depth;
+    char   board[ROWS][COLS];
+    char   human;
+    char   toMove;
+    Job    job;
+
+    Conn  *prev;
+    Conn  *next;
+};
+
+typedef struct {
+    int        epfd;
+    int        listenFd;
+    int        wakeFd;        // eventfd, signalled by workers
+    const char *unixPath;
+    int        maxClients;
+    int        defaultKind;
+    int        defaultDepth;
+    int        maxDepth;
+    const RLAgent *agent;     // NULL = no rl engine
+
+    // Search queue (workers) and finished jobs (I/O thread)
+    pthread_mutex_t lock;
+    pthread_cond_t  ready;
+    Job       *queueHead;
+    Job       *queueTail;
+    Job       *doneHead;
+    int        stopping;
+
+    Conn      *conns;         // every open connection
+    Conn      *closed;        // closed this round, freed after its events
+    int        clients;
+
+    // Totals, I/O thread only
+    long long  accepted;
+    long long  games;
+    long long  moves;
+    long long  searches;
+    double     searchMs;
+    double     maxSearchMs;
+} Server;
+
+typedef struct {
+    Server   *srv;
+    pthread_t thread;
+    C4Engine  ctx;
+} Worker;
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int sig) {
+    (void)sig;
+    stopRequested = 1;
+}
+
+// ---------------- Engine specs ----------------
+
+// minimax:D, solver or rl[:K]; fills kind and depth. 0 if invalid.
+static int parseEngineSpec(const Server *srv, const char *spec, int *kind, int *depth) {
+    char *end;
+    long d;
+
+    if (strcmp(spec, "solver") == 0) {
+        *kind = GAME_SOLVER;
+        *depth = 0;
+        return 1;
+    }
+    if (strncmp(spec, "minimax:", 8) == 0) {
+        d = strtol(spec + 8, &end, 10);
+        if (end == spec + 8 || *end != '\0' || d < 1 || d > srv->maxDepth) return 0;
+        *kind = GAME_MINIMAX;
+        *depth = (int)d;
+        return 1;
+    }
+    if (strncmp(spec, "rl", 2) == 0 && srv->agent) {
+        *kind = GAME_RL;
+        *depth = 3;
+        if (spec[2] == '\0') return 1;
+        if (spec[2] != ':') return 0;
+        d = strtol(spec + 3, &end, 10);
+        if (end == spec + 3 || *end != '\0' || d < 1 || d > srv->maxDepth) return 0;
+        *depth = (int)d;
+        return 1;
+    }
+    return 0;
+}
+
+// ---------------- Search workers ----------------
+
+static void runJob(Worker *w, Job *j) {
+    double start = timeNow();
+    if (j->kind == GAME_RL) {
+        setCPUDepth(&w->ctx, j->depth);
+        j->move = rl_choose_move(w->srv->agent, &w->ctx, j->board, j->piece, 0.0);
+    } else {
+        setCPUDepth(&w->ctx, (j->kind == GAME_SOLVER) ? 0 : j->depth);
+        j->move = getCPUMove(&w->ctx, j->board, j->piece);
+    }
+    j->ms = (timeNow() - start) * 1000.0;
+}
+
+static void *workerMain(void *arg) {
+    Worker *w = arg;
+    Server *srv = w->srv;
+
+    for (;;) {
+        pthread_mutex_lock(&srv->lock);
+        while (!srv->queueHead && !srv->stopping) pthread_cond_wait(&srv->ready, &srv->lock);
+        Job *j = srv->queueHead;
+        if (!j) {
+            pthread_mutex_unlock(&srv->lock);
+            break;
+        }
+        srv->queueHead = j->next;
+        if (!srv->queueHead) srv->queueTail = NULL;
+        pthread_mutex_unlock(&srv->lock);
+
+        runJob(w, j);
+
+        pthread_mutex_lock(&srv->lock);
+        j->next = srv->doneHead;
+        srv->doneHead = j;
+        pthread_mutex_unlock(&srv->lock);
+
+        uint64_t one = 1;
+        if (write(srv->wakeFd, &one, sizeof(one)) < 0) {
+            // The counter cannot overflow here; nothing to recover
+        }
+    }
+    return NULL;
+}
+
+static void queueJob(Server *srv, Job *j) {
+    j->next = NULL;
+    pthread_mutex_lock(&srv->lock);
+    if (srv->queueTail) srv->queueTail->next = j;
+    else                srv->queueHead = j;
+    srv->queueTail = j;
+    pthread_cond_signal(&srv->ready);
+    pthread_mutex_unlock(&srv->lock);
+}
+
+// ---------------- Connections ----------------
+
+static void updateEvents(Server *srv, Conn *c) {
+    unsigned int want = 0;
+    if (!c->busy && !c->closeAfterWrite && c->outLen < SERVER_OUT_MAX) want |= EPOLLIN;
+    if (c->outLen > 0) want |= EPOLLOUT;
+    if (want == c->events) return;
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = want;
+    ev.data.ptr = c;
+    epoll_ctl(srv->epfd, EPOLL_CTL_MOD, c->fd, &ev);
+    c->events = want;
+}
+
+static void freeConn(Conn *c) {
+    free(c->out);
+    free(c);
+}
+
+// Close the socket. The Conn itself is freed at the end of the event
+// round (a later event of the same round may still point to it), or when
+// its search comes back.
+static void closeConn(Server *srv, Conn *c) {
+    if (c->fd < 0) return;
+    epoll_ctl(srv->epfd, EPOLL_CTL_DEL, c->fd, NULL);
+    close(c->fd);
+    c->fd = -1;
+    srv->clients--;
+
+    if (c->prev) c->prev->next = c->next;
+    else         srv->conns = c->next;
+    if (c->next) c->next->prev = c->prev;
+
+    c->next = srv->closed;
+    srv->closed = c;
+}
+
+static void freeClosed(Server *srv) {
+    while (srv->closed) {
+        Conn *c = srv->closed;
+        srv->closed = c->next;
+        if (!c->busy) freeConn(c);
+    }
+}
+
+// Send as much of the output buffer as the socket takes. 0 if the
+// connection was closed.
+static int flushOut(Server *srv, Conn *c) {
+    size_t sent = 0;
+    while (sent < c->outLen) {
+        ssize_t n = send(c->fd, c->out + sent, c->outLen - sent, MSG_NOSIGNAL);
+        if (n > 0) {
+            sent += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConn(srv, c);
+            return 0;
+        }
+    }
+    memmove(c->out, c->out + sent, c->outLen - sent);
+    c->outLen -= sent;
+
+    if (c->outLen == 0 && c->closeAfterWrite) {
+        closeConn(srv, c);
+        return 0;
+    }
+    updateEvents(srv, c);
+    return 1;
+}
+
+static void reply(Conn *c, const char *fmt, ...) {
+    char line[SERVER_LINE_MAX];
+    va_list ap;
+    va_start(ap, fmt);
+    int len = vsnprintf(line, sizeof(line) - 1, fmt, ap);
+    va_end(ap);
+    if (len < 0) return;
+    if ((size_t)len > sizeof(line) - 2) len = (int)sizeof(line) - 2;
+    line[len++] = '\n';
+
+    if (c->outLen + (size_t)len > c->outCap) {
+        size_t cap = c->outCap ? c->outCap * 2 : 512;
+        while (cap < c->outLen + (size_t)len) cap *= 2;
+        char *out = realloc(c->out, cap);
+        if (!out) return;
+        c->out = out;
+        c->outCap = cap;
+    }
+    memcpy(c->out + c->outLen, line, (size_t)len);
+    c->outLen += (size_t)len;
+}
+
+// ---------------- Games ----------------
+
+static char otherPiece(char piece) {
+    return (piece == PLAYER1) ? PLAYER2 : PLAYER1;
+}
+
+static void startSearch(Server *srv, Conn *c) {
+    Job *j = &c->job;
+    j->conn = c;
+    memcpy(j->board, c->board, sizeof(j->board));
+    j->piece = c->toMove;
+    j->kind = c->kind;
+    j->depth = c->depth;
+    j->move = -1;
+    c->busy = 1;
+    queueJob(srv, j);
+}
+
+// Apply a finished engine move and answer the client.
+static void finishSearch(Server *srv, Job *j) {
+    Conn *c = j->conn;
+    c->busy = 0;
+    srv->searches++;
+    srv->searchMs += j->ms;
+    if (j->ms > srv->maxSearchMs) srv->maxSearchMs = j->ms;
+
+    if (c->fd < 0) {
+        freeConn(c);
+        return;
+    }
+
+    int col = j->move;
+    if (!isMoveValid(c->board, col)) {
+        reply(c, "err engine failed");
+        c->over = 1;
+    } else {
+        int row = dropPiece(c->board, col, c->toMove);
+        srv->moves++;
+        if (checkWin(c->board, c->toMove, row, col)) {
+            c->over = 1;
+            reply(c, "reply %d loss", col + 1);
+        } else if (isBoardFull(c->board)) {
+            c->over = 1;
+            reply(c, "reply %d draw", col + 1);
+        } else {
+            c->toMove = otherPiece(c->toMove);
+            reply(c, "reply %d", col + 1);
+        }
+    }
+}
+
+static void cmdNew(Server *srv, Conn *c, char *args) {
+    int kind = srv->defaultKind;
+    int depth = srv->defaultDepth;
+    int engineFirst = 0;
+    char *save = NULL;
+
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (strcmp(tok, "first") == 0) {
+            engineFirst = 0;
+        } else if (strcmp(tok, "second") == 0) {
+            engineFirst = 1;
+        } else if (!parseEngineSpec(srv, tok, &kind, &depth)) {
+            reply(c, "err bad engine %s", tok);
+            return;
+        }
+    }
+
+    initializeBoard(c->board);
+    c->active = 1;
+    c->over = 0;
+    c->kind = kind;
+    c->depth = depth;
+    c->toMove = PLAYER1;
+    c->human = engineFirst ? PLAYER2 : PLAYER1;
+    srv->games++;
+
+    if (engineFirst) startSearch(srv, c);
+    else             reply(c, "ok");
+}
+
+static void cmdMove(Server *srv, Conn *c, const char *arg) {
+    char *end;
+    long col = arg ? strtol(arg, &end, 10) - 1 : -1;
+
+    if (!c->active) {
+        reply(c, "err no game");
+        return;
+    }
+    if (c->over) {
+        reply(c, "err game over");
+        return;
+    }
+    if (!arg || end == arg || *end != '\0' || !isMoveValid(c->board, (int)col)) {
+        reply(c, "err illegal move");
+        return;
+    }
+
+    int row = dropPiece(c->board, (int)col, c->human);
+    srv->moves++;
+    if (checkWin(c->board, c->human, row, (int)col)) {
+        c->over = 1;
+        reply(c, "end win");
+    } else if (isBoardFull(c->board)) {
+        c->over = 1;
+        reply(c, "end draw");
+    } else {
+        c->toMove = otherPiece(c->human);
+        startSearch(srv, c);
+    }
+}
+
+static void cmdBoard(Conn *c) {
+    char text[ROWS * (COLS + 1) + 1];
+    int n = 0;
+    for (int r = 0; r < ROWS; r++) {
+        if (r > 0) text[n++] = '/';
+        for (int col = 0; col < COLS; col++) {
+            text[n++] = c->active ? c->board[r][col] : EMPTY;
+        }
+    }
+    text[n] = '\0';
+
+    char toMove = (c->active && !c->over) ? c->toMove : '-';
+    reply(c, "board %s %c", text, toMove);
+}
+
+static void processLine(Server *srv, Conn *c, char *line) {
+    size_t len = strlen(line);
+    if (len > 0 && line[len - 1] == '\r') line[--len] = '\0';
+
+    char *save = NULL;
+    char *cmd = strtok_r(line, " \t", &save);
+    if (!cmd) return;   // empty line
+    char *rest = strtok_r(NULL, "", &save);
+
+    if (strcmp(cmd, "new") == 0) {
+        cmdNew(srv, c, rest ? rest : "");
+    } else if (strcmp(cmd, "move") == 0) {
+        char *arg = rest ? strtok_r(rest, " \t", &save) : NULL;
+        cmdMove(srv, c, arg);
+    } else if (strcmp(cmd, "board") == 0) {
+        cmdBoard(c);
+    } else if (strcmp(cmd, "quit") == 0) {
+        reply(c, "bye");
+        c->closeAfterWrite = 1;
+    } else {
+        reply(c, "err unknown command %s", cmd);
+    }
+}
+
+// Handle complete lines until the connection waits for a search.
+static void processInput(Server *srv, Conn *c) {
+    size_t start = 0;
+    while (!c->busy && !c->closeAfterWrite && c->outLen < SERVER_OUT_MAX) {
+        char *nl = memchr(c->in + start, '\n', c->inLen - start);
+        if (!nl) break;
+        *nl = '\0';
+        processLine(srv, c, c->in + start);
+        start = (size_t)(nl - c->in) + 1;
+    }
+    memmove(c->in, c->in + start, c->inLen - start);
+    c->inLen -= start;
+}
+
+static void onReadable(Server *srv, Conn *c) {
+    while (c->inLen < sizeof(c->in)) {
+        ssize_t n = recv(c->fd, c->in + c->inLen, sizeof(c->in) - c->inLen, 0);
+        if (n > 0) {
+            c->inLen += (size_t)n;
+        } else if (n < 0 && errno == EINTR) {
+            continue;
+        } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break;
+        } else {
+            closeConn(srv, c);   // EOF or error
+            return;
+        }
+    }
+
+    processInput(srv, c);
+    if (c->inLen == sizeof(c->in) && !memchr(c->in, '\n', c->inLen)) {
+        reply(c, "err line too long");
+        c->closeAfterWrite = 1;
+        c->inLen = 0;
+    }
+    flushOut(srv, c);
+}
+
+static void acceptClients(Server *srv) {
+    for (;;) {
+        int fd = accept(srv->listenFd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            return;   // EAGAIN, or out of descriptors until clients leave
+        }
+        if (srv->clients >= srv->maxClients) {
+            static const char full[] = "err server full\n";
+            if (send(fd, full, sizeof(full) - 1, MSG_NOSIGNAL) < 0) {
+                // The client is rejected either way
+            }
+            close(fd);
+            continue;
+        }
+
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+        if (!srv->unixPath) {
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        }
+
+        Conn *c = calloc(1, sizeof(Conn));
+        if (!c) {
+            close(fd);
+            continue;
+        }
+        c->fd = fd;
+        c->events = EPOLLIN;
+
+        struct epoll_event ev;
+        memset(&ev, 0, sizeof(ev));
+        ev.events = EPOLLIN;
+        ev.data.ptr = c;
+        if (epoll_ctl(srv->epfd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+            close(fd);
+            free(c);
+            continue;
+        }
+
+        c->next = srv->conns;
+        if (srv->conns) srv->conns->prev = c;
+        srv->conns = c;
+        srv->clients++;
+        srv->accepted++;
+    }
+}
+
+// Answer every connection whose search finished.
+static void collectResults(Server *srv) {
+    uint64_t count;
+    if (read(srv->wakeFd, &count, sizeof(count)) < 0) {
+        // Spurious wakeup; the done list is checked anyway
+    }
+
+    pthread_mutex_lock(&srv->lock);
+    Job *done = srv->doneHead;
+    srv->doneHead = NULL;
+    pthread_mutex_unlock(&srv->lock);
+
+    while (done) {
+        Job *j = done;
+        done = j->next;
+        Conn *c = j->conn;
+        finishSearch(srv, j);
+        if (c->fd < 0) continue;   // freed in finishSearch
+
+        // Requests the client pipelined behind the move
+        processInput(srv, c);
+        flushOut(srv, c);
+    }
+}
+
+// ---------------- Sockets ----------------
+
+static int openListener(Server *srv, const char *bindAddr, int port) {
+    int fd;
+    if (srv->unixPath) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (strlen(srv->unixPath) >= sizeof(addr.sun_path)) {
+            fprintf(stderr, "Socket path too long: %s\n", srv->unixPath);
+            return -1;
+        }
+        strcpy(addr.sun_path, srv->unixPath);
+        fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        unlink(srv->unixPath);   // stale socket of an earlier run
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror(srv->unixPath);
+            close(fd);
+            return -1;
+        }
+    } else {
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons((uint16_t)port);
+        if (inet_pton(AF_INET, bindAddr, &addr.sin_addr) != 1) {
+            fprintf(stderr, "Bad IPv4 address: %s\n", bindAddr);
+            return -1;
+        }
+        fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        if (bind(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+            perror("bind");
+            close(fd);
+            return -1;
+        }
+    }
+
+    if (listen(fd, SOMAXCONN) != 0) {
+        perror("listen");
+        close(fd);
+        return -1;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    return fd;
+}
+
+// Allow as many descriptors as the hard limit permits.
+static void raiseFileLimit(void) {
+    struct rlimit rl;
+    if (getrlimit(RLIMIT_NOFILE, &rl) == 0 && rl.rlim_cur < rl.rlim_max) {
+        rl.rlim_cur = rl.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &rl);
+    }
+}
+
+// ---------------- Event loop ----------------
+
+static void serve(Server *srv) {
+    struct epoll_event events[SERVER_EVENTS];
+
+    while (!stopRequested) {
+        int n = epoll_wait(srv->epfd, events, SERVER_EVENTS, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait");
+            return;
+        }
+
+        for (int i = 0; i < n; i++) {
+            void *ptr = events[i].data.ptr;
+            if (ptr == &srv->listenFd) {
+                acceptClients(srv);
+            } else if (ptr == &srv->wakeFd) {
+                collectResults(srv);
+            }
+        }
+
+        for (int i = 0; i < n; i++) {
+            void *ptr = events[i].data.ptr;
+            if (ptr == &srv->listenFd || ptr == &srv->wakeFd) continue;
+            Conn *c = ptr;
+            if (c->fd < 0) continue;
+            if (events[i].events & (EPOLLERR | EPOLLHUP) && !(events[i].events & EPOLLIN)) {
+                closeConn(srv, c);
+            } else if (events[i].events & EPOLLIN) {
+                onReadable(srv, c);
+            } else if (events[i].events & EPOLLOUT) {
+                flushOut(srv, c);
+            }
+        }
+        freeClosed(srv);
+    }
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --port N          TCP port on --bind (default 4747)\n");
+    printf("  --bind ADDR       IPv4 address to listen on (default 127.0.0.1)\n");
+    printf("  --unix PATH       Listen on a UNIX socket instead of TCP\n");
+    printf("  --workers N       Search worker threads (default 2)\n");
+    printf("  --engine SPEC     Engine of \"new\" without one (default minimax:8)\n");
+    printf("  --max-depth D     Deepest minimax or rl search a client may ask for (default 12)\n");
+    printf("  --movetime MS     Time budget per engine move (default none)\n");
+    printf("  --hash MB         Transposition table per worker in MB (default 16)\n");
+    printf("  --book PATH       Opening book file (default %s, \"none\" = off)\n", BOOK_PATH_DEFAULT);
+    printf("  --rl-model PATH   Self-learning model for the rl engine (default none)\n");
+    printf("  --max-clients N   Connections served at once (default 10000)\n");
+    printf("  --seed N          Seed for the workers' tie-breaks (default 1)\n");
+    printf("  --help            Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+int main(int argc, char **argv) {
+    int port = 4747;
+    const char *bindAddr = "127.0.0.1";
+    const char *unixPath = NULL;
+    int workers = 2;
+    const char *engineSpec = "minimax:8";
+    int maxDepth = 12;
+    int moveTimeMs = 0;
+    int hashMB = CPU_HASH_MB_DEFAULT;
+    const char *bookPath = BOOK_PATH_DEFAULT;
+    const char *modelPath = NULL;
+    int maxClients = 10000;
+    int seed = 1;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--port") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &port) && port < 65536) {
+            i++;
+        } else if (strcmp(arg, "--bind") == 0 && i + 1 < argc) {
+            bindAddr = argv[++i];
+        } else if (strcmp(arg, "--unix") == 0 && i + 1 < argc) {
+            unixPath = argv[++i];
+        } else if (strcmp(arg, "--workers") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &workers)) {
+            i++;
+        } else if (strcmp(arg, "--engine") == 0 && i + 1 < argc) {
+            engineSpec = argv[++i];
+        } else if (strcmp(arg, "--max-depth") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &maxDepth) && maxDepth >= 1) {
+            i++;
+        } else if (strcmp(arg, "--movetime") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &moveTimeMs)) {
+            i++;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &hashMB)) {
+            i++;
+        } else if (strcmp(arg, "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else if (strcmp(arg, "--rl-model") == 0 && i + 1 < argc) {
+            modelPath = argv[++i];
+        } else if (strcmp(arg, "--max-clients") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &maxClients) && maxClients > 0) {
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seed)) {
+            i++;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (workers < 1) workers = 1;
+    if (workers > SERVER_MAX_WORKERS) workers = SERVER_MAX_WORKERS;
+
+    Server srv;
+    memset(&srv, 0, sizeof(srv));
+    srv.unixPath = unixPath;
+    srv.maxClients = maxClients;
+    srv.maxDepth = maxDepth;
+
+    RLAgent *agent = NULL;
+    if (modelPath) {
+        agent = malloc(sizeof(RLAgent));
+        if (!agent) return 1;
+        rl_init(agent);
+        if (!rl_load(agent, modelPath)) {
+            fprintf(stderr, "Could not load model %s\n", modelPath);
+            free(agent);
+            return 1;
+        }
+        srv.agent = agent;
+    }
+    if (!parseEngineSpec(&srv, engineSpec, &srv.defaultKind, &srv.defaultDepth)) {
+        fprintf(stderr, "Bad engine spec: %s\n", engineSpec);
+        free(agent);
+        return 1;
+    }
+
+    Book book;
+    memset(&book, 0, sizeof(book));
+    int haveBook = 0;
+    if (strcmp(bookPath, "none") != 0) {
+        haveBook = bookOpen(&book, bookPath);
+        if (!haveBook && strcmp(bookPath, BOOK_PATH_DEFAULT) != 0) {
+            fprintf(stderr, "Could not open opening book %s\n", bookPath);
+            free(agent);
+            return 1;
+        }
+    }
+
+    raiseFileLimit();
+    srv.listenFd = openListener(&srv, bindAddr, port);
+    srv.epfd = epoll_create1(0);
+    srv.wakeFd = eventfd(0, EFD_NONBLOCK);
+    if (srv.listenFd < 0 || srv.epfd < 0 || srv.wakeFd < 0) {
+        fprintf(stderr, "Could not set up the server socket.\n");
+        free(agent);
+        return 1;
+    }
+
+    struct epoll_event ev;
+    memset(&ev, 0, sizeof(ev));
+    ev.events = EPOLLIN;
+    ev.data.ptr = &srv.listenFd;
+    epoll_ctl(srv.epfd, EPOLL_CTL_ADD, srv.listenFd, &ev);
+    ev.data.ptr = &srv.wakeFd;
+    epoll_ctl(srv.epfd, EPOLL_CTL_ADD, srv.wakeFd, &ev);
+
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = onSignal;
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    // Search workers, each with its own engine context
+    pthread_mutex_init(&srv.lock, NULL);
+    pthread_cond_init(&srv.ready, NULL);
+    Worker *pool = calloc((size_t)workers, sizeof(Worker));
+    if (!pool) return 1;
+    int started = 0;
+    for (int i = 0; i < workers; i++) {
+        Worker *w = &pool[i];
+        w->srv = &srv;
+        initCPUEngine(&w->ctx);
+        seedCPUEngine(&w->ctx, (uint64_t)seed + (uint64_t)i);
+        setCPUSearchBudget(&w->ctx, moveTimeMs, 0);
+        if (haveBook) setCPUBook(&w->ctx, &book);
+        if (!setCPUHashSize(&w->ctx, hashMB)) {
+            fprintf(stderr, "Could not allocate a %d MB transposition table.\n", hashMB);
+            freeCPUEngine(&w->ctx);
+            break;
+        }
+        if (pthread_create(&w->thread, NULL, workerMain, w) != 0) {
+            freeCPUEngine(&w->ctx);
+            break;
+        }
+        started++;
+    }
+
+    if (started == workers) {
+        if (unixPath) printf("Listening on %s", unixPath);
+        else          printf("Listening on %s:%d", bindAddr, port);
+        printf(" with %d search worker%s%s\n", workers, workers == 1 ? "" : "s",
+               haveBook ? ", opening book loaded" : "");
+        fflush(stdout);
+
+        double start = timeNow();
+        serve(&srv);
+        double secs = timeNow() - start;
+
+        printf("\n%lld connections, %lld games, %lld moves in %.1f s\n",
+               srv.accepted, srv.games, srv.moves, secs);
+        if (srv.searches > 0) {
+            printf("%lld engine moves, %.2f ms average, %.2f ms slowest\n",
+                   srv.searches, srv.searchMs / srv.searches, srv.maxSearchMs);
+        }
+    }
+
+    // Drop queued searches, let the running ones finish, then close
+    // every connection
+    pthread_mutex_lock(&srv.lock);
+    srv.stopping = 1;
+    Job *dropped = srv.queueHead;
+    srv.queueHead = srv.queueTail = NULL;
+    pthread_cond_broadcast(&srv.ready);
+    pthread_mutex_unlock(&srv.lock);
+    for (int i = 0; i < started; i++) {
+        pthread_join(pool[i].thread, NULL);
+        freeCPUEngine(&pool[i].ctx);
+    }
+    free(pool);
+
+    // A connection closed while its search was queued or running is on
+    // no list any more; its job is the last reference to it
+    for (int pass = 0; pass < 2; pass++) {
+        Job *j = pass ? srv.doneHead : dropped;
+        while (j) {
+            Job *next = j->next;
+            Conn *c = j->conn;
+            c->busy = 0;
+            if (c->fd < 0) freeConn(c);
+            j = next;
+        }
+    }
+    srv.doneHead = NULL;
+
+    while (srv.conns) closeConn(&srv, srv.conns);
+    while (srv.closed) {
+        Conn *c = srv.closed;
+        srv.closed = c->next;
+        freeConn(c);
+    }
+
+    close(srv.listenFd);
+    close(srv.epfd);
+    close(srv.wakeFd);
+    if (unixPath) unlink(unixPath);
+    if (haveBook) bookClose(&book);
+    free(agent);
+    return (started == workers) ? 0 : 1;
+}
+
+#else
+
+int main(void) {
+    fprintf(stderr, "c4_server needs Linux (epoll).\n");
+    return 1;
+}
+
+#endif
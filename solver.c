@@ -0,0 +1,241 @@
+#include <string.h>
+#include "solver.h"
+#include "timeutil.h"
+
+// The solver works on the usual "stones of the side to move + all stones"
+// pair, which makes negamax symmetric.
+typedef struct {
+    uint64_t current;   // stones of the side to move
+    uint64_t mask;      // all stones
+    int      moves;
+} SolverPos;
+
+static const int solverOrder[COLS] = {3, 2, 4, 1, 5, 0, 6};
+
+static uint64_t posKey(const SolverPos *p) {
+    return p->current + p->mask + BB_BOTTOM_MASK;
+}
+
+static uint64_t possibleMoves(const SolverPos *p) {
+    return (p->mask + BB_BOTTOM_MASK) & BB_BOARD_MASK;
+}
+
+static int canWinNext(const SolverPos *p) {
+    return (bbWinningCells(p->current, p->mask) & possibleMoves(p)) != 0;
+}
+
+// Moves that do not hand the opponent an immediate win. Returns 0 when
+// every move loses (opponent has two threats, or a threat sits right above
+// the only forced block).
+static uint64_t nonLosingMoves(const SolverPos *p) {
+    uint64_t possible = possibleMoves(p);
+    uint64_t opponentWin = bbWinningCells(p->current ^ p->mask, p->mask);
+    uint64_t forced = possible & opponentWin;
+
+    if (forced) {
+        if (forced & (forced - 1)) return 0;  // two forced blocks: lost
+        possible = forced;
+    }
+    return possible & ~(opponentWin >> 1);    // don't play under a threat
+}
+
+// Play a move given as its single landing bit.
+static void playBit(SolverPos *p, uint64_t move) {
+    p->current ^= p->mask;
+    p->mask |= move;
+    p->moves++;
+}
+
+// Move ordering heuristic: number of threats the move creates.
+static int moveScore(const SolverPos *p, uint64_t move) {
+    return bbPopcount(bbWinningCells(p->current | move, p->mask));
+}
+
+static int negamax(Solver *s, const SolverPos *p, int alpha, int beta) {
+    s->nodes++;
+
+    uint64_t next = nonLosingMoves(p);
+    if (next == 0) return -(ROWS * COLS - p->moves) / 2;
+    if (p->moves >= ROWS * COLS - 2) return 0;
+
+    // We can't win next move (callers check that), and the opponent can't
+    // win on their next move either, so the score is bounded.
+    int min = -(ROWS * COLS - 2 - p->moves) / 2;
+    if (alpha < min) {
+        alpha = min;
+        if (alpha >= beta) return alpha;
+    }
+
+    int max = (ROWS * COLS - 1 - p->moves) / 2;
+
+    uint64_t key = posKey(p);
+    TTData hit;
+    if (ttProbe(&s->tt, key, &hit)) {
+        if (hit.bound == TT_LOWER) {
+            if (alpha < hit.score) {
+                alpha = hit.score;
+                if (alpha >= beta) return alpha;
+            }
+        } else if (hit.score < max) {
+            max = hit.score;
+        }
+    }
+    if (beta > max) {
+        beta = max;
+        if (alpha >= beta) return beta;
+    }
+
+    // Order moves by threats created, center-first on ties
+    uint64_t moves[COLS];
+    int scores[COLS];
+    int n = 0;
+    for (int i = 0; i < COLS; i++) {
+        uint64_t move = next & BB_COLUMN_MASK(solverOrder[i]);
+        if (!move) continue;
+        int sc = moveScore(p, move);
+        int k = n++;
+        while (k > 0 && scores[k - 1] < sc) {
+            moves[k] = moves[k - 1];
+            scores[k] = scores[k - 1];
+            k--;
+        }
+        moves[k] = move;
+        scores[k] = sc;
+    }
+
+    for (int i = 0; i < n; i++) {
+        SolverPos child = *p;
+        playBit(&child, moves[i]);
+        int score = -negamax(s, &child, -beta, -alpha);
+
+        if (score >= beta) {
+            ttStore(&s->tt, key, score, 0, TT_LOWER, TT_NO_MOVE);
+            return score;
+        }
+        if (score > alpha) alpha = score;
+    }
+
+    ttStore(&s->tt, key, alpha, 0, TT_UPPER, TT_NO_MOVE);
+    return alpha;
+}
+
+static void toSolverPos(const Bitboard *bb, int who, SolverPos *p) {
+    p->current = bb->pieces[who];
+    p->mask = bbOccupied(bb);
+    p->moves = bb->moves;
+}
+
+int solverInit(Solver *s, size_t hashMB) {
+    memset(s, 0, sizeof(*s));
+    return ttInit(&s->tt, hashMB);
+}
+
+void solverFree(Solver *s) {
+    ttFree(&s->tt);
+}
+
+void solverResetStats(Solver *s) {
+    s->nodes = 0;
+}
+
+int solverSolve(Solver *s, const Bitboard *bb, int who, int weak) {
+    SolverPos p;
+    toSolverPos(bb, who, &p);
+
+    if (canWinNext(&p)) return (ROWS * COLS + 1 - p.moves) / 2;
+
+    int min = -(ROWS * COLS - p.moves) / 2;
+    int max = (ROWS * COLS + 1 - p.moves) / 2;
+    if (weak) {
+        min = -1;
+        max = 1;
+    }
+
+    // Null-window bisection of the score range; probing around 0 first
+    // settles win/draw/loss quickly, which then narrows the range.
+    while (min < max) {
+        int med = min + (max - min) / 2;
+        if (med <= 0 && min / 2 < med)      med = min / 2;
+        else if (med >= 0 && max / 2 > med) med = max / 2;
+
+        int r = negamax(s, &p, med, med + 1);
+        if (r <= med) max = r;
+        else          min = r;
+    }
+    return min;
+}
+
+void solverAnalyze(Solver *s, const Bitboard *bb, int who, int scores[COLS]) {
+    for (int c = 0; c < COLS; c++) {
+        if (!bbCanPlay(bb, c)) {
+            scores[c] = SOLVER_INVALID;
+        } else if (bbIsWinningMove(bb, c, who)) {
+            scores[c] = (ROWS * COLS + 1 - bb->moves) / 2;
+        } else if (bb->moves + 1 >= ROWS * COLS) {
+            scores[c] = 0;   // last stone, no win: draw
+        } else {
+            Bitboard child = *bb;
+            bbPlay(&child, c, who);
+            scores[c] = -solverSolve(s, &child, who ^ 1, 0);
+        }
+    }
+}
+
+int solverPliesToEnd(int score, int moves) {
+    if (score == 0) return ROWS * COLS - moves;
+
+    // Stones on the board when the winner drops the winning stone
+    int winnerScore = (score > 0) ? score : -score;
+    int parity = (score > 0) ? ((moves + 1) & 1) : (moves & 1);
+    int last = ROWS * COLS + 1 - 2 * winnerScore - parity;
+    return last - moves + 1;
+}
+
+// First column (center-first) whose exact score reaches `target`, found
+// with one null-window search per candidate instead of a full solve.
+static int findMoveWithScore(Solver *s, const Bitboard *bb, int who, int target) {
+    for (int i = 0; i < COLS; i++) {
+        int c = solverOrder[i];
+        if (!bbCanPlay(bb, c)) continue;
+        if (bbIsWinningMove(bb, c, who)) return c;
+        if (bb->moves + 1 >= ROWS * COLS) return c;   // last stone: draw
+
+        Bitboard child = *bb;
+        bbPlay(&child, c, who);
+
+        SolverPos p;
+        toSolverPos(&child, who ^ 1, &p);
+        if (canWinNext(&p)) continue;   // hands the opponent a win
+
+        // child score <= -target  <=>  this move scores >= target
+        if (negamax(s, &p, -target, -target + 1) <= -target) return c;
+    }
+
+    // Every move loses at once; play any legal column
+    for (int i = 0; i < COLS; i++) {
+        if (bbCanPlay(bb, solverOrder[i])) return solverOrder[i];
+    }
+    return -1;
+}
+
+int solveBoard(Solver *s, char board[ROWS][COLS], char toMove, SolveResult *out) {
+    Bitboard bb;
+    bbFromBoard(&bb, board);
+    int who = bbIndex(toMove);
+
+    double start = timeNow();
+    uint64_t nodesBefore = s->nodes;
+
+    if (bbIsFull(&bb)) {
+        out->bestMove = -1;
+        out->score = 0;
+    } else {
+        out->score = solverSolve(s, &bb, who, 0);
+        out->bestMove = findMoveWithScore(s, &bb, who, out->score);
+    }
+
+    out->pliesToEnd = solverPliesToEnd(out->score, bb.moves);
+    out->nodes = s->nodes - nodesBefore;
+    out->ms = (timeNow() - start) * 1000.0;
+    return out->bestMove;
+}
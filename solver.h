@@ -0,0 +1,58 @@
+#ifndef SOLVER_H
+#define SOLVER_H
+
+#include <stdint.h>
+#include "connect_four.h"
+#include "bitboard.h"
+#include "ttable.h"
+
+// =======================================================
+// Perfect-play solver (negamax + alpha-beta + null-window search)
+// =======================================================
+//
+// Scores are from the side to move's point of view:
+//   0   draw with best play
+//   >0  side to move wins; the sooner the win, the larger the score
+//   <0  side to move loses; the later the loss, the closer to 0
+// A win on the side to move's k-th stone from an n-stone position scores
+// (ROWS*COLS + 1 - n) / 2 - (k - 1), the same scale as Pascal Pons'
+// solver.
+
+#define SOLVER_MIN_SCORE (-(ROWS * COLS) / 2 + 3)
+#define SOLVER_MAX_SCORE ((ROWS * COLS + 1) / 2 - 3)
+#define SOLVER_HASH_MB_DEFAULT 64
+
+typedef struct {
+    TTable   tt;
+    uint64_t nodes;     // negamax calls since the last solverResetStats
+} Solver;
+
+typedef struct {
+    int      score;       // solver score (see above)
+    int      bestMove;    // column 0..COLS-1, -1 if the board is full
+    int      pliesToEnd;  // plies until the game ends with best play (0 if over)
+    uint64_t nodes;
+    double   ms;          // wall-clock solve time
+} SolveResult;
+
+int  solverInit(Solver *s, size_t hashMB);
+void solverFree(Solver *s);
+void solverResetStats(Solver *s);
+
+// Exact score of the position with `who` (0/1) to move. The side to move
+// must not have already lost. With `weak` set only the sign is exact
+// (-1 loss, 0 draw, 1 win), which is much faster.
+int  solverSolve(Solver *s, const Bitboard *bb, int who, int weak);
+
+// Exact score of every column (SOLVER_INVALID for full columns).
+#define SOLVER_INVALID (-1000)
+void solverAnalyze(Solver *s, const Bitboard *bb, int who, int scores[COLS]);
+
+// Solve a game-loop board with `toMove` to play: best move, score,
+// distance to the end and solve time.
+int  solveBoard(Solver *s, char board[ROWS][COLS], char toMove, SolveResult *out);
+
+// Plies until the game ends for `score` in a position with `moves` stones.
+int  solverPliesToEnd(int score, int moves);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef TIMEUTIL_H
+#define TIMEUTIL_H
+
+#include <time.h>
+
+// Monotonic wall-clock time in seconds (for budgets and benchmarks).
+static inline double timeNow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+#endif
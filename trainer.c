@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "connect_four.h"
+#include "rl_agent.h"
+#include "gamelog.h"
+#include "timeutil.h"
+
+// =======================================================
+// Headless self-learning AI trainer (c4_train)
+// =======================================================
+//
+// Separates generating games from fitting the model:
+//   c4_train --games 200000 --log games.c4gl        play, learn and log
+//   c4_train --replay games.c4gl --epochs 4         learn from the log only
+// Both steps update and save the same model file the game loads.
+
+#define MODEL_PATH_DEFAULT "c4_model.bin"
+#define CHECKPOINT_SECS_DEFAULT 60
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]\n", prog);
+    printf("  --model PATH    Model file to load and save (default %s)\n", MODEL_PATH_DEFAULT);
+    printf("  --rl-model KIND linear or ntuple (default: as saved, else linear)\n");
+    printf("  --games N       Self-play training games (default 0)\n");
+    printf("  --log PATH      Append the self-play games to this experience log\n");
+    printf("  --replay PATH   Train on the games of an experience log\n");
+    printf("  --epochs N      Passes over the --replay log (default 1)\n");
+    printf("  --threads N     Training threads (default 1)\n");
+    printf("  --checkpoint S  Save the model every S seconds during self-play (default %d, 0 = off)\n",
+           CHECKPOINT_SECS_DEFAULT);
+    printf("  --seed N        Random seed for self-play (default: time)\n");
+    printf("  --help          Show this help\n");
+}
+
+static int parseIntArg(const char *s, int *out) {
+    char *endptr;
+    long val = strtol(s, &endptr, 10);
+    if (endptr == s || *endptr != '\0' || val < 0 || val > 1000000000L) return 0;
+    *out = (int)val;
+    return 1;
+}
+
+static void initModel(RLAgent *a, int model) {
+    if (model == RL_MODEL_NTUPLE) rl_init_ntuple(a);
+    else                          rl_init(a);
+}
+
+static const char *modelName(int model) {
+    return (model == RL_MODEL_NTUPLE) ? "ntuple" : "linear";
+}
+
+static int fileExists(const char *path) {
+    FILE *fp = fopen(path, "rb");
+    if (fp) fclose(fp);
+    return fp != NULL;
+}
+
+int main(int argc, char **argv) {
+    const char *modelPath = MODEL_PATH_DEFAULT;
+    const char *logPath = NULL;
+    const char *replayPath = NULL;
+    int model = -1;
+    int games = 0;
+    int epochs = 1;
+    int threads = 1;
+    int seed = 0;
+    int seedSet = 0;
+    int checkpointSecs = CHECKPOINT_SECS_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--model") == 0 && i + 1 < argc) {
+            modelPath = argv[++i];
+        } else if (strcmp(arg, "--rl-model") == 0 && i + 1 < argc &&
+                   (strcmp(argv[i + 1], "linear") == 0 || strcmp(argv[i + 1], "ntuple") == 0)) {
+            model = (strcmp(argv[++i], "ntuple") == 0) ? RL_MODEL_NTUPLE : RL_MODEL_LINEAR;
+        } else if (strcmp(arg, "--games") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &games)) {
+            i++;
+        } else if (strcmp(arg, "--log") == 0 && i + 1 < argc) {
+            logPath = argv[++i];
+        } else if (strcmp(arg, "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (strcmp(arg, "--epochs") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &epochs)) {
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &threads)) {
+            i++;
+        } else if (strcmp(arg, "--checkpoint") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &checkpointSecs)) {
+            i++;
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &seed)) {
+            i++;
+            seedSet = 1;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if (threads < 1) threads = 1;
+    if (threads > RL_MAX_THREADS) threads = RL_MAX_THREADS;
+    if (!seedSet) seed = (int)time(NULL);
+
+    RLAgent *agent = malloc(sizeof(*agent));
+    if (!agent) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    // An existing model file is only ever trained further, never replaced
+    initModel(agent, model);
+    if (rl_load(agent, modelPath)) {
+        if (model >= 0 && agent->model != model) {
+            fprintf(stderr, "%s holds a %s model; give --model PATH to train a fresh %s model\n",
+                    modelPath, modelName(agent->model), modelName(model));
+            free(agent);
+            return 1;
+        }
+        fprintf(stderr, "Loaded %s (%llu games trained)\n",
+                modelPath, (unsigned long long)agent->gamesTrained);
+    } else if (fileExists(modelPath)) {
+        fprintf(stderr, "Could not load %s (damaged or from a newer version); "
+                        "give --model PATH to train a fresh model\n", modelPath);
+        free(agent);
+        return 1;
+    } else {
+        fprintf(stderr, "Starting a fresh model\n");
+    }
+    rl_set_checkpoint(agent, modelPath, checkpointSecs);
+
+    // 0. Finish a run cut short after a checkpoint
+    if (agent->run.games > 0) {
+        fprintf(stderr, "Resuming interrupted self-play (%d of %d games done)\n",
+                agent->run.done, agent->run.games);
+        rl_train_resume(agent);
+    } else if (games == 0 && !replayPath) {
+        fprintf(stderr, "Nothing to do: give --games and/or --replay\n");
+        printUsage(argv[0]);
+        free(agent);
+        return 1;
+    }
+
+    int status = 0;
+
+    // 1. Self-play, optionally streaming the games to the log
+    if (games > 0) {
+        GameLogWriter writer;
+        if (logPath) {
+            if (!gameLogWriterOpen(&writer, logPath)) {
+                fprintf(stderr, "Could not open experience log %s\n", logPath);
+                free(agent);
+                return 1;
+            }
+            rl_set_game_log(agent, &writer);
+        }
+
+        double start = timeNow();
+        rl_train_selfplay_mt(agent, games, threads, (uint64_t)seed);
+        double secs = timeNow() - start;
+        fprintf(stderr, "Self-play: %d games in %.1f s (%.0f games/s)\n",
+                games, secs, (secs > 0.0) ? games / secs : 0.0);
+
+        if (logPath) {
+            rl_set_game_log(agent, NULL);
+            if (!gameLogWriterClose(&writer)) {
+                fprintf(stderr, "Writing experience log %s failed\n", logPath);
+                status = 1;
+            } else {
+                fprintf(stderr, "Appended %llu games to %s\n",
+                        (unsigned long long)writer.games, logPath);
+            }
+        }
+    }
+
+    // 2. Replay a log for a number of epochs
+    if (replayPath) {
+        GameLog log;
+        if (!gameLogOpen(&log, replayPath)) {
+            fprintf(stderr, "Could not open experience log %s\n", replayPath);
+            free(agent);
+            return 1;
+        }
+
+        double start = timeNow();
+        rl_train_from_log(agent, &log, epochs, threads);
+        double secs = timeNow() - start;
+        double replayed = (double)log.count * epochs;
+        fprintf(stderr, "Replay: %llu games x %d epoch%s in %.1f s (%.0f games/s)\n",
+                (unsigned long long)log.count, epochs, epochs == 1 ? "" : "s",
+                secs, (secs > 0.0) ? replayed / secs : 0.0);
+        gameLogClose(&log);
+    }
+
+    if (!rl_save_if_changed(agent, modelPath)) {
+        fprintf(stderr, "Could not save model to %s\n", modelPath);
+        status = 1;
+    } else {
+        fprintf(stderr, "Saved model to %s\n", modelPath);
+    }
+
+    free(agent);
+    return status;
+}
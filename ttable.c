@@ -0,0 +1,120 @@
+#include <stdlib.h>
+#include <string.h>
+#include "ttable.h"
+
+// data layout: bits  0..31 score (two's complement)
+//              bits 32..39 depth
+//              bits 40..47 bound
+//              bits 48..55 move + 1 (0 = no move)
+static uint64_t packData(int score, int depth, int bound, int move) {
+    return (uint64_t)(uint32_t)score |
+           ((uint64_t)(uint8_t)depth << 32) |
+           ((uint64_t)(uint8_t)bound << 40) |
+           ((uint64_t)(uint8_t)(move + 1) << 48);
+}
+
+static void unpackData(uint64_t data, TTData *out) {
+    out->score = (int)(int32_t)(uint32_t)(data & 0xffffffffULL);
+    out->depth = (int)((data >> 32) & 0xff);
+    out->bound = (int)((data >> 40) & 0xff);
+    out->move  = (int)((data >> 48) & 0xff) - 1;
+}
+
+// Bitboard keys are highly structured, so scramble them before indexing.
+static size_t slotFor(const TTable *tt, uint64_t key) {
+    uint64_t h = key * 0x9E3779B97F4A7C15ULL;
+    h ^= h >> 29;
+    return (size_t)(h & (tt->count - 1));
+}
+
+int ttInit(TTable *tt, size_t megabytes) {
+    size_t bytes = megabytes * 1024 * 1024;
+    size_t count = 1;
+
+    if (bytes < sizeof(TTEntry)) bytes = sizeof(TTEntry);
+    while (count * 2 * sizeof(TTEntry) <= bytes) count *= 2;
+
+    memset(tt, 0, sizeof(*tt));
+    // All-zero bytes are a valid empty entry for the atomic words too
+    tt->entries = calloc(count, sizeof(TTEntry));
+    if (!tt->entries) return 0;
+    tt->count = count;
+    return 1;
+}
+
+void ttFree(TTable *tt) {
+    free(tt->entries);
+    memset(tt, 0, sizeof(*tt));
+}
+
+// Must not run concurrently with searches.
+void ttClear(TTable *tt) {
+    for (size_t i = 0; i < tt->count; i++) {
+        atomic_store_explicit(&tt->entries[i].check, 0, memory_order_relaxed);
+        atomic_store_explicit(&tt->entries[i].data, 0, memory_order_relaxed);
+    }
+    ttResetStats(tt);
+}
+
+void ttResetStats(TTable *tt) {
+    tt->probes = 0;
+    tt->hits = 0;
+}
+
+void ttAddStats(TTable *tt, uint64_t probes, uint64_t hits) {
+    tt->probes += probes;
+    tt->hits += hits;
+}
+
+int ttProbe(const TTable *tt, uint64_t key, TTData *out) {
+    if (!tt->entries) return 0;
+
+    TTEntry *e = &tt->entries[slotFor(tt, key)];
+    uint64_t data  = atomic_load_explicit(&e->data, memory_order_relaxed);
+    uint64_t check = atomic_load_explicit(&e->check, memory_order_relaxed);
+
+    // An empty slot decodes to key 0, which no real position uses
+    if ((check ^ data) != key || key == 0) return 0;
+
+    unpackData(data, out);
+    return 1;
+}
+
+void ttStore(TTable *tt, uint64_t key, int score, int depth, int bound, int move) {
+    if (!tt->entries) return;
+
+    TTEntry *e = &tt->entries[slotFor(tt, key)];
+
+    // Keep a deeper result for the same position; otherwise always replace.
+    uint64_t oldData  = atomic_load_explicit(&e->data, memory_order_relaxed);
+    uint64_t oldCheck = atomic_load_explicit(&e->check, memory_order_relaxed);
+    if ((oldCheck ^ oldData) == key) {
+        TTData old;
+        unpackData(oldData, &old);
+        if (old.depth > depth) return;
+    }
+
+    uint64_t data = packData(score, depth, bound, move);
+    atomic_store_explicit(&e->check, key ^ data, memory_order_relaxed);
+    atomic_store_explicit(&e->data, data, memory_order_relaxed);
+}
+
+double ttHitRate(const TTable *tt) {
+    if (tt->probes == 0) return 0.0;
+    return (double)tt->hits / (double)tt->probes;
+}
+
+// Occupancy estimated from the first (up to) 4096 slots.
+double ttFillRate(const TTable *tt) {
+    if (!tt->entries) return 0.0;
+    size_t sample = tt->count < 4096 ? tt->count : 4096;
+    size_t used = 0;
+    for (size_t i = 0; i < sample; i++) {
+        if (atomic_load_explicit(&tt->entries[i].data, memory_order_relaxed) != 0) used++;
+    }
+    return (double)used / (double)sample;
+}
+
+size_t ttSizeBytes(const TTable *tt) {
+    return tt->count * sizeof(TTEntry);
+}
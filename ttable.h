@@ -0,0 +1,61 @@
+#ifndef TTABLE_H
+#define TTABLE_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// =======================================================
+// Transposition table (fixed size, configurable memory)
+// =======================================================
+//
+// Lock-free: several search threads may probe and store concurrently.
+// Each entry keeps `check = key ^ data`, so a probe that races with a
+// store (and sees one half old, one half new) fails validation instead of
+// returning a mixed-up entry.
+
+// Bound types for stored scores
+#define TT_EXACT 0
+#define TT_LOWER 1   // score is a lower bound (search failed high)
+#define TT_UPPER 2   // score is an upper bound (search failed low)
+
+#define TT_NO_MOVE (-1)
+
+typedef struct {
+    _Atomic uint64_t check;  // key ^ data
+    _Atomic uint64_t data;   // packed score / depth / bound / move
+} TTEntry;
+
+typedef struct {
+    int score;
+    int depth;
+    int bound;
+    int move;
+} TTData;
+
+// probes/hits are not touched by ttProbe itself (a shared counter would
+// be contended by every search thread); searches count locally and add
+// their totals with ttAddStats.
+typedef struct {
+    TTEntry *entries;
+    size_t   count;     // power of two
+    uint64_t probes;
+    uint64_t hits;
+} TTable;
+
+// Allocate roughly `megabytes` of entries (rounded down to a power of two).
+// Returns 1 on success, 0 on allocation failure.
+int    ttInit(TTable *tt, size_t megabytes);
+void   ttFree(TTable *tt);
+void   ttClear(TTable *tt);
+void   ttResetStats(TTable *tt);
+void   ttAddStats(TTable *tt, uint64_t probes, uint64_t hits);
+
+int    ttProbe(const TTable *tt, uint64_t key, TTData *out);
+void   ttStore(TTable *tt, uint64_t key, int score, int depth, int bound, int move);
+
+double ttHitRate(const TTable *tt);
+double ttFillRate(const TTable *tt);
+size_t ttSizeBytes(const TTable *tt);
+
+#endif
@@ -0,0 +1,347 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+#include "connect_four.h"
+#include "engine.h"
+#include "book.h"
+#include "searchstats.h"
+
+// =======================================================
+// Engine text protocol (c4_uci)
+// =======================================================
+//
+// A UCI-like line protocol on stdin/stdout for GUIs, tournament managers
+// and scripts; nothing is printed but protocol replies. Columns are 1-7
+// and a move string is a line of columns, e.g. "4453".
+//
+//   uci                          id lines, options, then "uciok"
+//   isready                      "readyok" (also while searching)
+//   setoption name N value V     Depth (0 = exact solver), MoveTime (ms),
+//                                Nodes, Threads, Hash (MB)
+//   ucinewgame                   forget the hash table
+//   position startpos [moves M]  empty board plus the moves M; "position M"
+//                                is short for the same
+//   go [depth D] [movetime MS] [nodes N] [infinite]
+//                                search the position on a background thread;
+//                                "info" after every finished depth, then
+//                                "bestmove C" ("bestmove none" if the game
+//                                is over)
+//   stop                         end the search; it still answers bestmove
+//   quit
+//
+// info lines: depth, score, nodes, nps, time in ms and the principal
+// variation. Lines during the search count the main thread's nodes; the
+// line before bestmove is the move played, with every thread's nodes.
+// Scores are from the side to move, on the scale of the engine used:
+//   minimax (Depth >= 1)  evaluation; above 500000 is a forced win, below
+//                         -500000 a forced loss; depth is the search depth
+//   solver  (Depth 0)     exact solver score (solver.h): 0 draw, > 0 win,
+//                         the larger the sooner; depth is the number of
+//                         plies until the game ends with best play
+//   book                  solver scale as well, depth 0
+// Commands other than isready, stop and quit wait until a running search
+// has ended. The solver (Depth 0) cannot be stopped.
+
+#define UCI_LINE_MAX 1024
+
+typedef struct {
+    C4Engine   engine;
+    char       board[ROWS][COLS];
+    char       toMove;
+    int        over;         // the position is won or full
+
+    // Settings (setoption); go's arguments override them for one search
+    int        depth;
+    int        moveTimeMs;
+    long long  nodes;
+
+    pthread_t  thread;
+    int        searching;    // thread started and not joined yet
+    atomic_int stop;
+
+    pthread_mutex_t outLock;
+} Uci;
+
+// One reply line; the search thread writes too.
+static void emit(Uci *u, const char *fmt, ...) {
+    va_list ap;
+    pthread_mutex_lock(&u->outLock);
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    putchar('\n');
+    fflush(stdout);
+    pthread_mutex_unlock(&u->outLock);
+}
+
+// ---------------- Search ----------------
+
+static void emitInfo(Uci *u, const SearchStats *st) {
+    char pv[SEARCH_MAX_PV * 2 + 1];
+    int n = 0;
+    for (int i = 0; i < st->pvLength; i++) {
+        n += snprintf(pv + n, sizeof(pv) - (size_t)n, " %d", st->pv[i] + 1);
+    }
+    pv[n] = '\0';
+
+    double nps = (st->ms > 0.0) ? st->nodes / (st->ms / 1000.0) : 0.0;
+    emit(u, "info depth %d score %.0f nodes %lld nps %.0f time %.0f pv%s",
+         st->depth, st->score, st->nodes, nps, st->ms, pv);
+}
+
+static void onIteration(const SearchStats *st, void *arg) {
+    emitInfo((Uci *)arg, st);
+}
+
+static void *searchMain(void *arg) {
+    Uci *u = arg;
+    int move = getCPUMove(&u->engine, u->board, u->toMove);
+
+    // The move played (ties are broken at random), with the nodes of all
+    // threads; book and solver moves have no iterations before it
+    emitInfo(u, &u->engine.stats);
+    emit(u, "bestmove %d", move + 1);
+    return NULL;
+}
+
+// Wait for the running search, if any; with `stop` end it first.
+static void endSearch(Uci *u, int stop) {
+    if (!u->searching) return;
+    if (stop) atomic_store(&u->stop, 1);
+    pthread_join(u->thread, NULL);
+    u->searching = 0;
+    atomic_store(&u->stop, 0);
+}
+
+// ---------------- Commands ----------------
+
+// Parse a non-negative integer; returns 0 on bad input.
+static int parseIntArg(const char *s, long long *out) {
+    char *endptr;
+    long long val = s ? strtoll(s, &endptr, 10) : -1;
+    if (!s || endptr == s || *endptr != '\0' || val < 0 || val > 1000000000LL) return 0;
+    *out = val;
+    return 1;
+}
+
+static void cmdSetOption(Uci *u, char *args) {
+    char *save = NULL;
+    char *name = NULL;
+    char *value = NULL;
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (strcmp(tok, "name") == 0)       name = strtok_r(NULL, " \t", &save);
+        else if (strcmp(tok, "value") == 0) value = strtok_r(NULL, " \t", &save);
+    }
+
+    long long v;
+    if (!name || !parseIntArg(value, &v)) {
+        emit(u, "info string usage: setoption name NAME value N");
+    } else if (strcmp(name, "Depth") == 0 && v <= ROWS * COLS) {
+        u->depth = (int)v;
+    } else if (strcmp(name, "MoveTime") == 0) {
+        u->moveTimeMs = (int)v;
+    } else if (strcmp(name, "Nodes") == 0) {
+        u->nodes = v;
+    } else if (strcmp(name, "Threads") == 0) {
+        setCPUThreads(&u->engine, (int)v);
+    } else if (strcmp(name, "Hash") == 0) {
+        if (!setCPUHashSize(&u->engine, (int)v)) {
+            emit(u, "info string could not allocate %lld MB", v);
+        }
+    } else {
+        emit(u, "info string unknown option or value: %s", name);
+    }
+}
+
+// Play a move string (columns 1-7, spaces allowed) from the empty board.
+static void cmdPosition(Uci *u, char *args) {
+    initializeBoard(u->board);
+    u->toMove = PLAYER1;
+    u->over = 0;
+
+    char *save = NULL;
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        if (strcmp(tok, "startpos") == 0 || strcmp(tok, "moves") == 0) continue;
+        for (const char *p = tok; *p; p++) {
+            int c = *p - '1';
+            if (u->over || c < 0 || c >= COLS || !isMoveValid(u->board, c)) {
+                emit(u, "info string illegal move %c, position ends before it", *p);
+                return;
+            }
+            int r = dropPiece(u->board, c, u->toMove);
+            if (checkWin(u->board, u->toMove, r, c) || isBoardFull(u->board)) u->over = 1;
+            u->toMove = (u->toMove == PLAYER1) ? PLAYER2 : PLAYER1;
+        }
+    }
+}
+
+static void cmdGo(Uci *u, char *args) {
+    int depth = u->depth;
+    int moveTimeMs = u->moveTimeMs;
+    long long nodes = u->nodes;
+
+    char *save = NULL;
+    for (char *tok = strtok_r(args, " \t", &save); tok; tok = strtok_r(NULL, " \t", &save)) {
+        long long v;
+        if (strcmp(tok, "infinite") == 0) {
+            depth = ROWS * COLS;
+            moveTimeMs = 0;
+            nodes = 0;
+        } else if (strcmp(tok, "depth") == 0 && parseIntArg(strtok_r(NULL, " \t", &save), &v) &&
+                   v <= ROWS * COLS) {
+            depth = (int)v;
+        } else if (strcmp(tok, "movetime") == 0 && parseIntArg(strtok_r(NULL, " \t", &save), &v)) {
+            moveTimeMs = (int)v;
+        } else if (strcmp(tok, "nodes") == 0 && parseIntArg(strtok_r(NULL, " \t", &save), &v)) {
+            nodes = v;
+        } else {
+            emit(u, "info string bad go argument %s", tok);
+            return;
+        }
+    }
+
+    if (u->over) {
+        emit(u, "bestmove none");
+        return;
+    }
+
+    setCPUDepth(&u->engine, depth);
+    setCPUSearchBudget(&u->engine, moveTimeMs, nodes);
+    if (pthread_create(&u->thread, NULL, searchMain, u) != 0) {
+        emit(u, "info string could not start the search");
+        return;
+    }
+    u->searching = 1;
+}
+
+// Returns 0 on quit.
+static int processLine(Uci *u, char *line) {
+    char *save = NULL;
+    char *cmd = strtok_r(line, " \t\r\n", &save);
+    if (!cmd) return 1;
+    char *rest = strtok_r(NULL, "\r\n", &save);
+    if (!rest) rest = "";
+
+    if (strcmp(cmd, "quit") == 0) {
+        endSearch(u, 1);
+        return 0;
+    } else if (strcmp(cmd, "stop") == 0) {
+        endSearch(u, 1);
+    } else if (strcmp(cmd, "isready") == 0) {
+        emit(u, "readyok");
+    } else if (strcmp(cmd, "uci") == 0) {
+        emit(u, "id name C-nnectFour");
+        emit(u, "id author C-nnectFour developers");
+        emit(u, "option name Depth type spin default %d min 0 max %d", u->depth, ROWS * COLS);
+        emit(u, "option name MoveTime type spin default %d min 0 max 1000000000", u->moveTimeMs);
+        emit(u, "option name Nodes type spin default %lld min 0 max 1000000000", u->nodes);
+        emit(u, "option name Threads type spin default %d min 1 max %d",
+             u->engine.threads, CPU_MAX_THREADS);
+        emit(u, "option name Hash type spin default %d min 0 max 65536", (int)u->engine.hashMB);
+        emit(u, "uciok");
+    } else {
+        // Everything else needs the engine context
+        endSearch(u, 0);
+        if (strcmp(cmd, "setoption") == 0) {
+            cmdSetOption(u, rest);
+        } else if (strcmp(cmd, "ucinewgame") == 0) {
+            clearCPUHash(&u->engine);
+        } else if (strcmp(cmd, "position") == 0) {
+            cmdPosition(u, rest);
+        } else if (strcmp(cmd, "go") == 0) {
+            cmdGo(u, rest);
+        } else {
+            emit(u, "info string unknown command %s", cmd);
+        }
+    }
+    return 1;
+}
+
+// ---------------- Command line ----------------
+
+static void printUsage(const char *prog) {
+    printf("Usage: %s [options]   (then speak the protocol on stdin)\n", prog);
+    printf("  --depth D         Search depth, 0 = exact solver (default 8)\n");
+    printf("  --hash MB         Transposition table size in MB (default %d)\n", CPU_HASH_MB_DEFAULT);
+    printf("  --threads N       Lazy-SMP search threads (default 1)\n");
+    printf("  --book PATH       Opening book file (default %s, \"none\" = off)\n", BOOK_PATH_DEFAULT);
+    printf("  --seed N          Seed for tie-breaks (default 1)\n");
+    printf("  --help            Show this help\n");
+}
+
+int main(int argc, char **argv) {
+    static Uci u;
+    long long depth = 8;
+    long long hashMB = CPU_HASH_MB_DEFAULT;
+    long long threads = 1;
+    long long seed = 1;
+    const char *bookPath = BOOK_PATH_DEFAULT;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            printUsage(argv[0]);
+            return 0;
+        } else if (strcmp(arg, "--depth") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &depth) && depth <= ROWS * COLS) {
+            i++;
+        } else if (strcmp(arg, "--hash") == 0 && i + 1 < argc && parseIntArg(argv[i + 1], &hashMB)) {
+            i++;
+        } else if (strcmp(arg, "--threads") == 0 && i + 1 < argc &&
+                   parseIntArg(argv[i + 1], &threads)) {
+            i++;
+        } else if (strcmp(arg, "--book") == 0 && i + 1 < argc) {
+            bookPath = argv[++i];
+        } else if (strcmp(arg, "--seed") == 0 && i + 1 < argc && parseIntArg(argv[i + 1], &seed)) {
+            i++;
+        } else {
+            fprintf(stderr, "Unknown or incomplete option: %s\n", arg);
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    initCPUEngine(&u.engine);
+    if (!setCPUHashSize(&u.engine, (int)hashMB)) {
+        fprintf(stderr, "Could not allocate a %lld MB transposition table.\n", hashMB);
+        return 1;
+    }
+    setCPUThreads(&u.engine, (int)threads);
+    seedCPUEngine(&u.engine, (uint64_t)seed);
+    u.depth = (int)depth;
+    pthread_mutex_init(&u.outLock, NULL);
+    atomic_init(&u.stop, 0);
+    setCPUStopFlag(&u.engine, &u.stop);
+    setCPUIterationCallback(&u.engine, onIteration, &u);
+
+    Book book;
+    memset(&book, 0, sizeof(book));
+    int haveBook = 0;
+    if (strcmp(bookPath, "none") != 0) {
+        haveBook = bookOpen(&book, bookPath);
+        if (!haveBook && strcmp(bookPath, BOOK_PATH_DEFAULT) != 0) {
+            fprintf(stderr, "Could not open opening book %s\n", bookPath);
+            freeCPUEngine(&u.engine);
+            return 1;
+        }
+        if (haveBook) setCPUBook(&u.engine, &book);
+    }
+
+    char empty[] = "";
+    cmdPosition(&u, empty);
+
+    char line[UCI_LINE_MAX];
+    while (fgets(line, sizeof(line), stdin)) {
+        if (!processLine(&u, line)) break;
+    }
+    endSearch(&u, 1);
+
+    freeCPUEngine(&u.engine);
+    if (haveBook) bookClose(&book);
+    pthread_mutex_destroy(&u.outLock);
+    return 0;
+}
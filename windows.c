@@ -0,0 +1,40 @@
+#include <pthread.h>
+#include "windows.h"
+#include "bitboard.h"
+
+static WindowTable table;
+static pthread_once_t tableOnce = PTHREAD_ONCE_INIT;
+
+static void buildWindowTable(void) {
+    // Directions: horizontal, vertical, diagonal down-right, diagonal up-right
+    const int dr[4] = {0, 1, 1, -1};
+    const int dc[4] = {1, 0, 1,  1};
+    int n = 0;
+
+    for (int d = 0; d < 4; d++) {
+        for (int r0 = 0; r0 < ROWS; r0++) {
+            for (int c0 = 0; c0 < COLS; c0++) {
+                int r3 = r0 + 3 * dr[d];
+                int c3 = c0 + 3 * dc[d];
+                if (r3 < 0 || r3 >= ROWS || c3 >= COLS) continue;
+
+                Window *w = &table.windows[n];
+                w->mask = 0;
+                for (int i = 0; i < 4; i++) {
+                    int r = r0 + i * dr[d];
+                    int c = c0 + i * dc[d];
+                    w->row[i] = (uint8_t)r;
+                    w->col[i] = (uint8_t)c;
+                    w->mask |= bbCellBit(r, c);
+                    table.cellWindows[r][c][table.cellWindowCount[r][c]++] = (uint8_t)n;
+                }
+                n++;
+            }
+        }
+    }
+}
+
+const WindowTable *windowTable(void) {
+    pthread_once(&tableOnce, buildWindowTable);
+    return &table;
+}
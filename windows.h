@@ -0,0 +1,34 @@
+#ifndef WINDOWS_H
+#define WINDOWS_H
+
+#include <stdint.h>
+#include "connect_four.h"
+
+// =======================================================
+// Precomputed table of all 4-cell windows
+// =======================================================
+//
+// Every horizontal, vertical and diagonal line of four cells on the board,
+// in one flat array, plus an index from each cell to the windows passing
+// through it. Shared by the minimax evaluation, the RL feature extractor
+// and the threat / win highlighting in the console display.
+
+#define NUM_WINDOWS      69
+#define MAX_CELL_WINDOWS 16   // 4 directions x 4 offsets
+
+typedef struct {
+    uint64_t mask;      // bitboard bits of the 4 cells
+    uint8_t  row[4];    // board[][] coordinates of the cells, in line order
+    uint8_t  col[4];
+} Window;
+
+typedef struct {
+    Window  windows[NUM_WINDOWS];
+    uint8_t cellWindows[ROWS][COLS][MAX_CELL_WINDOWS];
+    uint8_t cellWindowCount[ROWS][COLS];
+} WindowTable;
+
+// Built once on first call (thread-safe); the table is read-only after that.
+const WindowTable *windowTable(void);
+
+#endif